@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "mapeo.h"
+
+// El registro de consumo ocupa una página de cabecera seguida de las reservas.
+const size_t kTamanoCabeceraRegistro = 4096;
+const char kMagicoRegistro[8] = {'V', 'E', 'R', 'N', 'A', 'M', 'P', 'D'};
+
+/**
+ * @brief Cabecera del registro de consumo, compartida entre hilos y procesos.
+ *
+ * siguiente y reservas se modifican solo con operaciones atómicas sobre la
+ * proyección compartida del fichero.
+ */
+struct CabeceraRegistro {
+  char magico[8];
+  uint64_t tamano_pad;
+  uint64_t siguiente;  // Primer byte del pad sin usar: todo lo anterior está consumido
+  uint64_t reservas;   // Número de reservas anotadas a continuación de la cabecera
+};
+
+// Entrada del registro: rango [desplazamiento, desplazamiento + longitud) del pad.
+struct RegistroReserva {
+  uint64_t desplazamiento;
+  uint64_t longitud;
+};
+
+/**
+ * @brief Almacén de pads de un solo uso.
+ *
+ * Proyecta en memoria un fichero de pad y mantiene junto a él un registro
+ * persistente (<pad>.registro) con los rangos ya consumidos. El pad se gasta
+ * de forma monótona, de modo que el siguiente rango libre es siempre el
+ * contador siguiente de la cabecera (consulta O(1)) y reservar es un
+ * compare-and-swap sobre él: varios hilos o procesos pueden reservar rangos
+ * disjuntos a la vez sin ningún cerrojo global. Un rango reservado nunca se
+ * devuelve, aunque el cifrado falle después.
+ */
+class AlmacenPad {
+ public:
+  explicit AlmacenPad(const std::string& ruta_pad);
+  ~AlmacenPad();
+
+  AlmacenPad(const AlmacenPad&) = delete;
+  AlmacenPad& operator=(const AlmacenPad&) = delete;
+
+  RegistroReserva Reservar(size_t longitud);
+  RegistroReserva Cifrar(const uint8_t* mensaje, uint8_t* cifrado, size_t longitud);
+  void Descifrar(const RegistroReserva& reserva, const uint8_t* cifrado, uint8_t* mensaje) const;
+
+  size_t Consumido() const;
+  size_t Disponible() const;
+  size_t Reservas() const;
+
+  ArchivoMapeado& Pad() { return pad_; }
+  const ArchivoMapeado& Registro() const { return *registro_; }
+
+ private:
+  void CrearRegistro(const std::string& ruta_registro);
+
+  ArchivoMapeado pad_;
+  std::unique_ptr<ArchivoMapeado> registro_;
+  CabeceraRegistro* cabecera_;
+  int fd_registro_;
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Conversión entre bytes y texto binario ('0'/'1', 8 caracteres por byte, el
+// bit más significativo primero). Ambas funciones escriben en buffers ya
+// reservados por quien llama y admiten trabajar en el sitio:
+//  - CodificarBits: texto puede apuntar a bytes si el buffer tiene 8 * longitud bytes.
+//  - DecodificarBits: bytes puede apuntar a texto.
+void CodificarBits(const uint8_t* bytes, size_t longitud, char* texto);
+void DecodificarBits(const char* texto, size_t longitud, uint8_t* bytes);
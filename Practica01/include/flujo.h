@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "mapeo.h"
+
+// Tamaño del bloque que se lee, cifra y escribe en cada iteración del modo flujo.
+const size_t kTamanoBloque = 1 << 20;
+
+size_t CifrarFlujo(int entrada, int salida, ArchivoMapeado& pad, size_t desplazamiento = 0,
+                   size_t maximo = SIZE_MAX);
+
+// Conversión por bloques entre bytes y texto binario ('0'/'1'), para pads en formato texto.
+size_t CodificarFlujo(int entrada, int salida);
+size_t DecodificarFlujo(int entrada, int salida);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "mapeo.h"
+
+// Tamaño de los trozos que reparten los hilos (múltiplo del tamaño de página).
+const size_t kTamanoTrozo = 4 << 20;
+
+size_t CifrarParalelo(const std::string& ruta_entrada, const std::string& ruta_salida, ArchivoMapeado& pad,
+                      size_t desplazamiento = 0, unsigned hilos = 0);
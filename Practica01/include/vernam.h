@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Núcleo del cifrado: trabaja sobre bytes empaquetados (8 bits por byte).
+void CifradoVerman(const uint8_t* mensaje, const uint8_t* clave, uint8_t* cifrado, size_t longitud);
+std::vector<uint8_t> CifradoVerman(const std::vector<uint8_t>& mensaje, const std::vector<uint8_t>& clave);
+
+// Adaptadores de texto: solo se usan en los extremos (entrada/salida por consola).
+std::string ConvertirBinario(const std::string& mensaje);
+std::string CifradoASCII(const std::string& cifrado);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Firma común de todas las implementaciones del XOR masivo: salida = a ^ b.
+// La salida puede coincidir con cualquiera de las entradas (XOR en el sitio).
+using FuncionXor = void (*)(const uint8_t* a, const uint8_t* b, uint8_t* salida, size_t longitud);
+
+struct ImplementacionXor {
+  const char* nombre;
+  FuncionXor funcion;
+};
+
+// A partir de este tamaño (y si la salida no es una de las entradas) se usan
+// almacenamientos no temporales: el resultado no cabe en caché y escribirlo
+// sin pasar por ella ahorra ancho de banda.
+const size_t kUmbralNoTemporal = 8 << 20;
+
+// XOR masivo con la mejor implementación disponible, elegida al arrancar según CPUID.
+void XorBuffers(const uint8_t* a, const uint8_t* b, uint8_t* salida, size_t longitud);
+const char* NombreXorActivo();
+
+// Implementaciones soportadas por la CPU actual (la portable siempre está).
+std::vector<ImplementacionXor> ImplementacionesXor();
@@ -0,0 +1,147 @@
+#include "../include/almacen_pad.h"
+#include "../include/vernam.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Abre el pad y su registro de consumo, creando el registro si no existe.
+ *
+ * @param ruta_pad
+ */
+AlmacenPad::AlmacenPad(const std::string& ruta_pad) : pad_(ruta_pad), cabecera_(nullptr), fd_registro_(-1) {
+  const std::string ruta_registro = ruta_pad + ".registro";
+  if (access(ruta_registro.c_str(), F_OK) != 0) CrearRegistro(ruta_registro);
+
+  fd_registro_ = open(ruta_registro.c_str(), O_RDWR);
+  if (fd_registro_ < 0) {
+    throw std::runtime_error("No se puede abrir " + ruta_registro + ": " + std::strerror(errno));
+  }
+  try {
+    registro_ = std::make_unique<ArchivoMapeado>(ruta_registro, ArchivoMapeado::kLecturaEscritura);
+    if (registro_->Tamano() < kTamanoCabeceraRegistro) {
+      throw std::runtime_error(ruta_registro + " no es un registro de consumo válido");
+    }
+    cabecera_ = reinterpret_cast<CabeceraRegistro*>(registro_->Datos());
+    if (std::memcmp(cabecera_->magico, kMagicoRegistro, sizeof(kMagicoRegistro)) != 0) {
+      throw std::runtime_error(ruta_registro + " no es un registro de consumo válido");
+    }
+    if (cabecera_->tamano_pad != pad_.Tamano()) {
+      throw std::runtime_error("El tamaño del pad no coincide con el de su registro de consumo");
+    }
+  } catch (...) {
+    close(fd_registro_);
+    throw;
+  }
+}
+
+AlmacenPad::~AlmacenPad() {
+  registro_->Sincronizar();
+  close(fd_registro_);
+}
+
+/**
+ * @brief Crea un registro vacío de forma atómica.
+ *
+ * La cabecera se escribe en un fichero temporal que después se enlaza con el
+ * nombre definitivo. Si otro proceso lo ha creado entretanto, se usa el suyo.
+ *
+ * @param ruta_registro
+ */
+void AlmacenPad::CrearRegistro(const std::string& ruta_registro) {
+  std::string plantilla = ruta_registro + ".XXXXXX";
+  std::vector<char> temporal(plantilla.begin(), plantilla.end());
+  temporal.push_back('\0');
+  int fd = mkstemp(temporal.data());
+  if (fd < 0) {
+    throw std::runtime_error("No se puede crear " + ruta_registro + ": " + std::strerror(errno));
+  }
+  std::vector<uint8_t> pagina(kTamanoCabeceraRegistro, 0);
+  CabeceraRegistro cabecera = {};
+  std::memcpy(cabecera.magico, kMagicoRegistro, sizeof(kMagicoRegistro));
+  cabecera.tamano_pad = pad_.Tamano();
+  std::memcpy(pagina.data(), &cabecera, sizeof(cabecera));
+  if (write(fd, pagina.data(), pagina.size()) != static_cast<ssize_t>(pagina.size()) || fsync(fd) != 0) {
+    int error = errno;
+    close(fd);
+    unlink(temporal.data());
+    throw std::runtime_error("No se puede crear " + ruta_registro + ": " + std::strerror(error));
+  }
+  close(fd);
+  if (link(temporal.data(), ruta_registro.c_str()) != 0 && errno != EEXIST) {
+    int error = errno;
+    unlink(temporal.data());
+    throw std::runtime_error("No se puede crear " + ruta_registro + ": " + std::strerror(error));
+  }
+  unlink(temporal.data());
+}
+
+/**
+ * @brief Reserva los siguientes longitud bytes sin usar del pad.
+ *
+ * El rango se toma con un compare-and-swap sobre el contador compartido y
+ * después se anota en el registro. Lanza std::runtime_error si el pad no
+ * tiene material sin usar suficiente.
+ *
+ * @param longitud
+ * @return RegistroReserva
+ */
+RegistroReserva AlmacenPad::Reservar(size_t longitud) {
+  if (longitud == 0) throw std::invalid_argument("No se puede reservar un rango vacío");
+  const uint64_t tamano = cabecera_->tamano_pad;
+  uint64_t actual = __atomic_load_n(&cabecera_->siguiente, __ATOMIC_ACQUIRE);
+  do {
+    if (longitud > tamano - actual) {
+      throw std::runtime_error("El pad no tiene material sin usar suficiente");
+    }
+  } while (!__atomic_compare_exchange_n(&cabecera_->siguiente, &actual, actual + longitud, true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+  RegistroReserva reserva = {actual, longitud};
+  uint64_t indice = __atomic_fetch_add(&cabecera_->reservas, 1, __ATOMIC_RELAXED);
+  off_t posicion = static_cast<off_t>(kTamanoCabeceraRegistro + indice * sizeof(RegistroReserva));
+  if (pwrite(fd_registro_, &reserva, sizeof(reserva), posicion) != static_cast<ssize_t>(sizeof(reserva))) {
+    throw std::runtime_error(std::string("No se puede anotar la reserva: ") + std::strerror(errno));
+  }
+  return reserva;
+}
+
+/**
+ * @brief Reserva material nuevo del pad y cifra el mensaje con él.
+ *
+ * @param mensaje
+ * @param cifrado Puede coincidir con mensaje
+ * @param longitud
+ * @return RegistroReserva Rango usado; hace falta para descifrar
+ */
+RegistroReserva AlmacenPad::Cifrar(const uint8_t* mensaje, uint8_t* cifrado, size_t longitud) {
+  RegistroReserva reserva = Reservar(longitud);
+  CifradoVerman(mensaje, pad_.Datos() + reserva.desplazamiento, cifrado, longitud);
+  return reserva;
+}
+
+/**
+ * @brief Descifra con el rango del pad con el que se cifró (no consume material).
+ *
+ * @param reserva
+ * @param cifrado
+ * @param mensaje Puede coincidir con cifrado
+ */
+void AlmacenPad::Descifrar(const RegistroReserva& reserva, const uint8_t* cifrado, uint8_t* mensaje) const {
+  if (reserva.desplazamiento > pad_.Tamano() || reserva.longitud > pad_.Tamano() - reserva.desplazamiento) {
+    throw std::invalid_argument("El rango queda fuera del pad");
+  }
+  CifradoVerman(cifrado, pad_.Datos() + reserva.desplazamiento, mensaje, reserva.longitud);
+}
+
+size_t AlmacenPad::Consumido() const { return __atomic_load_n(&cabecera_->siguiente, __ATOMIC_ACQUIRE); }
+
+size_t AlmacenPad::Disponible() const { return cabecera_->tamano_pad - Consumido(); }
+
+size_t AlmacenPad::Reservas() const { return __atomic_load_n(&cabecera_->reservas, __ATOMIC_ACQUIRE); }
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../include/mapeo.h"
+#include "../include/paralelo.h"
+#include "../include/xor.h"
+
+// Bytes mínimos a procesar por medida, para que los tamaños pequeños no den ruido.
+const size_t kBytesPorMedida = size_t(512) << 20;
+
+/**
+ * @brief Mide el rendimiento (GB/s) de una implementación de XOR para un tamaño.
+ *
+ * Con salida == mensaje el XOR se hace en el sitio, como en el modo flujo;
+ * con un buffer aparte, como en el modo paralelo.
+ *
+ * @param funcion
+ * @param mensaje
+ * @param clave
+ * @param salida
+ * @param longitud
+ * @return double
+ */
+double MedirXor(FuncionXor funcion, const uint8_t* mensaje, const uint8_t* clave, uint8_t* salida, size_t longitud) {
+  size_t repeticiones = kBytesPorMedida / longitud;
+  if (repeticiones == 0) repeticiones = 1;
+  // Calentamiento: primera pasada fuera de la medida (fallos de página, cachés).
+  funcion(mensaje, clave, salida, longitud);
+  auto inicio = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < repeticiones; ++r) {
+    funcion(mensaje, clave, salida, longitud);
+  }
+  std::chrono::duration<double> segundos = std::chrono::steady_clock::now() - inicio;
+  return double(longitud) * double(repeticiones) / segundos.count() / 1e9;
+}
+
+/**
+ * @brief Benchmark del XOR masivo: GB/s por implementación y tamaño de buffer.
+ *
+ * Se mide dos veces: en el sitio y con la salida en otro buffer. Solo en el
+ * segundo caso, desde kUmbralNoTemporal, AVX2 y AVX-512 usan almacenamientos
+ * no temporales.
+ *
+ * @param maximo Tamaño de buffer más grande (se empieza en 64 bytes)
+ */
+void BenchmarkXor(size_t maximo) {
+  std::vector<uint8_t> mensaje(maximo, 0x5a), clave(maximo, 0xa5), salida(maximo);
+  std::vector<ImplementacionXor> implementaciones = ImplementacionesXor();
+
+  std::cout << "Implementación activa: " << NombreXorActivo() << std::endl;
+  for (bool en_sitio : {true, false}) {
+    std::cout << std::endl;
+    std::cout << (en_sitio ? "En el sitio (mensaje ^= clave)" : "Fuera del sitio (salida = mensaje ^ clave)")
+              << std::endl;
+    std::cout << std::setw(12) << "Tamaño";
+    for (const ImplementacionXor& impl : implementaciones) std::cout << std::setw(12) << impl.nombre;
+    std::cout << "   (GB/s)" << std::endl;
+
+    for (size_t longitud = 64; longitud <= maximo; longitud *= 4) {
+      std::cout << std::setw(12) << longitud;
+      for (const ImplementacionXor& impl : implementaciones) {
+        uint8_t* destino = en_sitio ? mensaje.data() : salida.data();
+        double gbs = MedirXor(impl.funcion, mensaje.data(), clave.data(), destino, longitud);
+        std::cout << std::setw(12) << std::fixed << std::setprecision(2) << gbs;
+      }
+      std::cout << (!en_sitio && longitud >= kUmbralNoTemporal ? "   no temporal" : "") << std::endl;
+    }
+  }
+}
+
+/**
+ * @brief Crea un fichero temporal de tamano bytes con contenido no trivial.
+ *
+ * @param tamano
+ * @return std::string Ruta del fichero
+ */
+std::string CrearTemporal(size_t tamano) {
+  char ruta[] = "/tmp/vernam_benchmark_XXXXXX";
+  int fd = mkstemp(ruta);
+  if (fd < 0) throw std::runtime_error("No se puede crear un fichero temporal");
+  std::vector<uint8_t> bloque(1 << 20);
+  for (size_t i = 0; i < bloque.size(); ++i) bloque[i] = static_cast<uint8_t>(i * 131 + 7);
+  for (size_t escritos = 0; escritos < tamano;) {
+    size_t n = std::min(bloque.size(), tamano - escritos);
+    if (write(fd, bloque.data(), n) != static_cast<ssize_t>(n)) {
+      close(fd);
+      throw std::runtime_error("No se puede escribir el fichero temporal");
+    }
+    escritos += n;
+  }
+  close(fd);
+  return ruta;
+}
+
+/**
+ * @brief Benchmark de escalado del modo paralelo, de 1 a hilos_max hilos.
+ *
+ * Para cada número de hilos se toma la mejor de 3 ejecuciones sobre ficheros
+ * en /tmp (tras la primera, entrada y pad ya están en la caché de páginas).
+ *
+ * @param tamano Bytes del fichero de entrada
+ * @param hilos_max
+ */
+void BenchmarkParalelo(size_t tamano, unsigned hilos_max) {
+  const std::string entrada = CrearTemporal(tamano);
+  const std::string ruta_pad = CrearTemporal(tamano);
+  const std::string salida = entrada + ".cifrado";
+  {
+    ArchivoMapeado pad(ruta_pad);
+    std::cout << "Entrada de " << tamano << " bytes, trozos de " << kTamanoTrozo << " bytes" << std::endl << std::endl;
+    std::cout << std::setw(8) << "Hilos" << std::setw(12) << "GB/s" << std::setw(14) << "Aceleración" << std::endl;
+    double base = 0;
+    for (unsigned hilos = 1; hilos <= hilos_max; ++hilos) {
+      double mejor = 0;
+      for (int repeticion = 0; repeticion < 3; ++repeticion) {
+        auto inicio = std::chrono::steady_clock::now();
+        CifrarParalelo(entrada, salida, pad, 0, hilos);
+        std::chrono::duration<double> segundos = std::chrono::steady_clock::now() - inicio;
+        mejor = std::max(mejor, double(tamano) / segundos.count() / 1e9);
+      }
+      if (hilos == 1) base = mejor;
+      std::cout << std::setw(8) << hilos << std::setw(12) << std::fixed << std::setprecision(2) << mejor
+                << std::setw(11) << mejor / base << "x" << std::endl;
+    }
+  }
+  unlink(entrada.c_str());
+  unlink(ruta_pad.c_str());
+  unlink(salida.c_str());
+}
+
+/**
+ * @brief Benchmarks de Vernam.
+ *
+ * Uso:
+ *   ./benchmark [xor] [tamano_maximo]        GB/s del XOR por tamaño, en el sitio y fuera (por defecto hasta 1 GiB)
+ *   ./benchmark paralelo [tamano] [hilos]    escalado de 1 a N hilos (por defecto 1 GiB, todos los núcleos)
+ */
+int main(int argc, char* argv[]) {
+  std::string modo = argc > 1 ? argv[1] : "xor";
+  int primero = 2;
+  if (modo != "xor" && modo != "paralelo") {
+    modo = "xor";
+    primero = 1;
+  }
+  size_t tamano = size_t(1) << 30;
+  if (argc > primero) tamano = std::strtoull(argv[primero], nullptr, 10);
+  try {
+    if (modo == "paralelo") {
+      unsigned hilos = std::thread::hardware_concurrency();
+      if (argc > primero + 1) hilos = static_cast<unsigned>(std::strtoul(argv[primero + 1], nullptr, 10));
+      if (tamano == 0 || hilos == 0) {
+        std::cerr << "El tamaño y el número de hilos deben ser positivos" << std::endl;
+        return 1;
+      }
+      BenchmarkParalelo(tamano, hilos);
+    } else {
+      if (tamano < 64) {
+        std::cerr << "El tamaño máximo debe ser de al menos 64 bytes" << std::endl;
+        return 1;
+      }
+      BenchmarkXor(tamano);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,282 @@
+/*
+    Cifrado:
+111011111001011100011111
+    Clave:
+101111001101100001010011
+    Descifrado:
+010100110100111101001100
+
+*/
+
+#include <cerrno>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../include/almacen_pad.h"
+#include "../include/flujo.h"
+#include "../include/paralelo.h"
+#include "../include/vernam.h"
+
+/**
+ * @brief Muestra la forma de uso del programa.
+ *
+ * @param programa
+ */
+void MostrarUso(const char* programa) {
+  std::cerr << "Uso:" << std::endl;
+  std::cerr << "  " << programa << "                                   (modo interactivo)" << std::endl;
+  std::cerr << "  " << programa << " --flujo <pad> [entrada] [salida]  (por defecto stdin/stdout, '-' también)" << std::endl;
+  std::cerr << "  " << programa << " --paralelo <hilos> <pad> <entrada> <salida>  (0 hilos = todos los núcleos)" << std::endl;
+  std::cerr << "  " << programa << " --pad-cifrar <pad> <entrada> [salida]" << std::endl;
+  std::cerr << "  " << programa << " --pad-descifrar <pad> <desplazamiento> [entrada] [salida]" << std::endl;
+  std::cerr << "  " << programa << " --pad-estado <pad>" << std::endl;
+  std::cerr << "  " << programa << " --a-bits [entrada] [salida]       (bytes -> texto '0'/'1')" << std::endl;
+  std::cerr << "  " << programa << " --de-bits [entrada] [salida]      (texto '0'/'1' -> bytes)" << std::endl;
+}
+
+/**
+ * @brief Abre un fichero del modo flujo; "-" o ausente indica la entrada/salida estándar.
+ *
+ * La salida se trunca solo después de comprobar que no es el fichero de
+ * entrada ni uno de los proyectados (pad, registro): si lo fuera, se vaciaría
+ * antes de leerlo, y truncar una proyección termina con SIGBUS.
+ *
+ * @param ruta
+ * @param escritura
+ * @param entrada Descriptor de entrada ya abierto (al abrir la salida), o -1
+ * @param mapeados Ficheros proyectados que la salida no puede sobrescribir
+ * @return int Descriptor
+ */
+int AbrirDescriptor(const char* ruta, bool escritura, int entrada = -1,
+                    std::initializer_list<const ArchivoMapeado*> mapeados = {}) {
+  if (ruta == nullptr || std::string(ruta) == "-") return escritura ? STDOUT_FILENO : STDIN_FILENO;
+  int fd = escritura ? open(ruta, O_WRONLY | O_CREAT, 0644) : open(ruta, O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("No se puede abrir ") + ruta + ": " + std::strerror(errno));
+  }
+  if (escritura) {
+    if (entrada >= 0 && MismoArchivo(entrada, fd)) {
+      close(fd);
+      throw std::invalid_argument("La entrada y la salida son el mismo fichero");
+    }
+    for (const ArchivoMapeado* mapeado : mapeados) {
+      if (mapeado->MismoArchivo(fd)) {
+        close(fd);
+        throw std::invalid_argument("La salida no puede ser el pad ni su registro");
+      }
+    }
+    if (ftruncate(fd, 0) < 0) {
+      int error = errno;
+      close(fd);
+      throw std::runtime_error(std::string("No se puede truncar ") + ruta + ": " + std::strerror(error));
+    }
+  }
+  return fd;
+}
+
+/**
+ * @brief Cierra los descriptores del modo flujo que no sean los estándar.
+ *
+ * @param entrada
+ * @param salida
+ */
+void CerrarDescriptores(int entrada, int salida) {
+  if (entrada != STDIN_FILENO) close(entrada);
+  if (salida != STDOUT_FILENO && close(salida) < 0) {
+    throw std::runtime_error(std::string("Error al cerrar la salida: ") + std::strerror(errno));
+  }
+}
+
+/**
+ * @brief Modo flujo: cifra la entrada por bloques con un pad proyectado en memoria.
+ *
+ * La memoria usada es constante, así que sirve para ficheros o tuberías de
+ * cualquier tamaño. El mismo comando descifra.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoFlujo(int argc, char* argv[]) {
+  if (argc < 3 || argc > 5) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  ArchivoMapeado pad(argv[2]);
+  int entrada = AbrirDescriptor(argc > 3 ? argv[3] : nullptr, false);
+  int salida = AbrirDescriptor(argc > 4 ? argv[4] : nullptr, true, entrada, {&pad});
+  size_t total = CifrarFlujo(entrada, salida, pad);
+  CerrarDescriptores(entrada, salida);
+  std::cerr << "Procesados " << total << " bytes" << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Modo paralelo: reparte un fichero grande entre varios hilos.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoParalelo(int argc, char* argv[]) {
+  if (argc != 6) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  unsigned hilos = static_cast<unsigned>(std::stoul(argv[2]));
+  ArchivoMapeado pad(argv[3]);
+  size_t total = CifrarParalelo(argv[4], argv[5], pad, 0, hilos);
+  std::cerr << "Procesados " << total << " bytes" << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Cifra un fichero con material nuevo del almacén de pads.
+ *
+ * La longitud debe conocerse de antemano para reservarla, por lo que la
+ * entrada tiene que ser un fichero regular. El desplazamiento reservado se
+ * muestra por la salida de error: es necesario para descifrar.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoPadCifrar(int argc, char* argv[]) {
+  if (argc < 4 || argc > 5) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  AlmacenPad almacen(argv[2]);
+  int entrada = AbrirDescriptor(argv[3], false);
+  struct stat info;
+  if (fstat(entrada, &info) < 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+    throw std::invalid_argument("La entrada debe ser un fichero regular no vacío");
+  }
+  // La salida se abre antes de reservar: si se rechaza, no se consume pad.
+  int salida = AbrirDescriptor(argc > 4 ? argv[4] : nullptr, true, entrada, {&almacen.Pad(), &almacen.Registro()});
+  RegistroReserva reserva = almacen.Reservar(static_cast<size_t>(info.st_size));
+  CifrarFlujo(entrada, salida, almacen.Pad(), reserva.desplazamiento, reserva.longitud);
+  CerrarDescriptores(entrada, salida);
+  std::cerr << "Desplazamiento en el pad: " << reserva.desplazamiento << std::endl;
+  std::cerr << "Longitud: " << reserva.longitud << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Descifra con el rango del pad que se indicó al cifrar (no consume material).
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoPadDescifrar(int argc, char* argv[]) {
+  if (argc < 4 || argc > 6) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  ArchivoMapeado pad(argv[2]);
+  size_t desplazamiento = std::stoull(argv[3]);
+  int entrada = AbrirDescriptor(argc > 4 ? argv[4] : nullptr, false);
+  int salida = AbrirDescriptor(argc > 5 ? argv[5] : nullptr, true, entrada, {&pad});
+  CifrarFlujo(entrada, salida, pad, desplazamiento);
+  CerrarDescriptores(entrada, salida);
+  return 0;
+}
+
+/**
+ * @brief Muestra cuánto material del pad se ha consumido.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoPadEstado(int argc, char* argv[]) {
+  if (argc != 3) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  AlmacenPad almacen(argv[2]);
+  std::cout << "Consumido: " << almacen.Consumido() << " bytes" << std::endl;
+  std::cout << "Disponible: " << almacen.Disponible() << " bytes" << std::endl;
+  std::cout << "Reservas: " << almacen.Reservas() << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Convierte entre bytes y texto binario por bloques (pads en formato texto).
+ *
+ * @param argc
+ * @param argv
+ * @param a_bits true: bytes -> texto; false: texto -> bytes
+ * @return int
+ */
+int ModoConversion(int argc, char* argv[], bool a_bits) {
+  if (argc > 4) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  int entrada = AbrirDescriptor(argc > 2 ? argv[2] : nullptr, false);
+  int salida = AbrirDescriptor(argc > 3 ? argv[3] : nullptr, true, entrada);
+  if (a_bits) {
+    CodificarFlujo(entrada, salida);
+  } else {
+    DecodificarFlujo(entrada, salida);
+  }
+  CerrarDescriptores(entrada, salida);
+  return 0;
+}
+
+/**
+ * @brief Modo interactivo: mensaje en texto y clave en binario por consola.
+ *
+ * @return int
+ */
+int ModoInteractivo() {
+  std::string mensaje, clave;
+  std::cout << "Mensaje: ";
+  std::cin >> mensaje;
+  std::cout << "Clave: ";
+  std::cin >> clave;
+  if (mensaje.size() * 8 != clave.size()) {
+    std::cout << "Mensaje y clave no tienen misma longitud" << std::endl;
+    return 1;
+  }
+  try {
+    // La clave llega como texto binario; el núcleo trabaja sobre bytes empaquetados.
+    std::string clave_bytes = CifradoASCII(clave);
+    std::vector<uint8_t> cifrado = CifradoVerman(std::vector<uint8_t>(mensaje.begin(), mensaje.end()),
+                                                 std::vector<uint8_t>(clave_bytes.begin(), clave_bytes.end()));
+    std::string cifrado_ascii(cifrado.begin(), cifrado.end());
+    std::cout << "Cifrado: " << ConvertirBinario(cifrado_ascii) << std::endl;
+    std::cout << "Cifrado ASCII: " << cifrado_ascii << std::endl;
+  } catch (const std::invalid_argument& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc == 1) return ModoInteractivo();
+  try {
+    std::string modo = argv[1];
+    if (modo == "--flujo") return ModoFlujo(argc, argv);
+    if (modo == "--paralelo") return ModoParalelo(argc, argv);
+    if (modo == "--pad-cifrar") return ModoPadCifrar(argc, argv);
+    if (modo == "--pad-descifrar") return ModoPadDescifrar(argc, argv);
+    if (modo == "--pad-estado") return ModoPadEstado(argc, argv);
+    if (modo == "--a-bits") return ModoConversion(argc, argv, true);
+    if (modo == "--de-bits") return ModoConversion(argc, argv, false);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  MostrarUso(argv[0]);
+  return 1;
+}
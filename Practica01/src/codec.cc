@@ -0,0 +1,196 @@
+#include "../include/codec.h"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VERNAM_X86 1
+#endif
+
+namespace {
+
+// Los 8 caracteres ('0'/'1') de un byte, el bit más significativo primero.
+struct ExpansionByte {
+  char bits[8];
+};
+
+/**
+ * @brief Genera en compilación la tabla byte -> 8 caracteres.
+ *
+ * @return std::array<ExpansionByte, 256>
+ */
+constexpr std::array<ExpansionByte, 256> GenerarTablaExpansion() {
+  std::array<ExpansionByte, 256> tabla = {};
+  for (int byte = 0; byte < 256; ++byte) {
+    for (int bit = 0; bit < 8; ++bit) {
+      tabla[byte].bits[bit] = static_cast<char>('0' + ((byte >> (7 - bit)) & 1));
+    }
+  }
+  return tabla;
+}
+
+/**
+ * @brief Genera en compilación la tabla que invierte el orden de los bits de un byte.
+ *
+ * movemask deja el carácter 0 en el bit 0, pero en el texto es el bit más significativo.
+ *
+ * @return std::array<uint8_t, 256>
+ */
+constexpr std::array<uint8_t, 256> GenerarTablaInversion() {
+  std::array<uint8_t, 256> tabla = {};
+  for (int byte = 0; byte < 256; ++byte) {
+    for (int bit = 0; bit < 8; ++bit) {
+      if (byte & (1 << bit)) tabla[byte] |= static_cast<uint8_t>(0x80 >> bit);
+    }
+  }
+  return tabla;
+}
+
+constexpr std::array<ExpansionByte, 256> kTablaExpansion = GenerarTablaExpansion();
+constexpr std::array<uint8_t, 256> kTablaInversion = GenerarTablaInversion();
+
+[[noreturn]] void LanzarTextoInvalido() {
+  throw std::invalid_argument("La cadena binaria solo puede contener '0' y '1'");
+}
+
+/**
+ * @brief Empaqueta 8 caracteres en un byte sin bucle por carácter.
+ *
+ * Se cargan como una palabra de 64 bits: restando '0' a cada byte queda 0 o 1
+ * y la multiplicación por 0x8040201008040201 reúne esos bits en el byte alto,
+ * con el primer carácter como bit más significativo.
+ *
+ * @param texto
+ * @return uint8_t
+ */
+uint8_t EmpaquetarByte(const char* texto) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  uint64_t x;
+  std::memcpy(&x, texto, sizeof(x));
+  x ^= 0x3030303030303030ULL;
+  if (x & ~0x0101010101010101ULL) LanzarTextoInvalido();
+  return static_cast<uint8_t>((x * 0x8040201008040201ULL) >> 56);
+#else
+  uint8_t byte = 0;
+  for (int bit = 0; bit < 8; ++bit) {
+    if (texto[bit] != '0' && texto[bit] != '1') LanzarTextoInvalido();
+    byte = static_cast<uint8_t>((byte << 1) | (texto[bit] - '0'));
+  }
+  return byte;
+#endif
+}
+
+void DecodificarPortable(const char* texto, size_t longitud, uint8_t* bytes) {
+  for (size_t i = 0; i < longitud; i += 8) {
+    bytes[i / 8] = EmpaquetarByte(texto + i);
+  }
+}
+
+#ifdef VERNAM_X86
+
+/**
+ * @brief Decodificación SSE2: 16 caracteres (2 bytes) por iteración.
+ *
+ * Una comparación con '1' y movemask dan los 16 bits; la tabla de inversión
+ * los pone en el orden del texto.
+ */
+__attribute__((target("sse2")))
+void DecodificarSse2(const char* texto, size_t longitud, uint8_t* bytes) {
+  const __m128i cero = _mm_set1_epi8('0');
+  const __m128i uno = _mm_set1_epi8('1');
+  size_t i = 0;
+  for (; i + 16 <= longitud; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(texto + i));
+    __m128i es_uno = _mm_cmpeq_epi8(v, uno);
+    __m128i valido = _mm_or_si128(_mm_cmpeq_epi8(v, cero), es_uno);
+    if (_mm_movemask_epi8(valido) != 0xFFFF) LanzarTextoInvalido();
+    int mascara = _mm_movemask_epi8(es_uno);
+    bytes[i / 8] = kTablaInversion[mascara & 0xFF];
+    bytes[i / 8 + 1] = kTablaInversion[mascara >> 8];
+  }
+  DecodificarPortable(texto + i, longitud - i, bytes + i / 8);
+}
+
+/**
+ * @brief Decodificación AVX2: 32 caracteres (4 bytes) por iteración.
+ *
+ * Antes de movemask se invierte el orden de cada grupo de 8 caracteres con un
+ * shuffle, de modo que la máscara de 32 bits ya son los 4 bytes de salida.
+ */
+__attribute__((target("avx2")))
+void DecodificarAvx2(const char* texto, size_t longitud, uint8_t* bytes) {
+  const __m256i cero = _mm256_set1_epi8('0');
+  const __m256i uno = _mm256_set1_epi8('1');
+  const __m256i inversion = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                             7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  size_t i = 0;
+  for (; i + 32 <= longitud; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(texto + i));
+    __m256i es_uno = _mm256_cmpeq_epi8(v, uno);
+    __m256i valido = _mm256_or_si256(_mm256_cmpeq_epi8(v, cero), es_uno);
+    if (_mm256_movemask_epi8(valido) != -1) LanzarTextoInvalido();
+    uint32_t mascara = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_shuffle_epi8(es_uno, inversion)));
+    std::memcpy(bytes + i / 8, &mascara, sizeof(mascara));
+  }
+  DecodificarSse2(texto + i, longitud - i, bytes + i / 8);
+}
+
+#endif  // VERNAM_X86
+
+using FuncionDecodificar = void (*)(const char*, size_t, uint8_t*);
+
+/**
+ * @brief Elige la decodificación más ancha que soporta la CPU (consulta CPUID).
+ *
+ * @return FuncionDecodificar
+ */
+FuncionDecodificar SeleccionarDecodificador() {
+#ifdef VERNAM_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return DecodificarAvx2;
+  if (__builtin_cpu_supports("sse2")) return DecodificarSse2;
+#endif
+  return DecodificarPortable;
+}
+
+// Se resuelve una única vez al arrancar el programa.
+const FuncionDecodificar kDecodificar = SeleccionarDecodificador();
+
+}  // namespace
+
+/**
+ * @brief Convierte bytes a texto binario con la tabla de expansión.
+ *
+ * Se recorre de atrás hacia delante para que el texto pueda ocupar el mismo
+ * buffer que los bytes: cada byte se lee antes de que su posición se sobrescriba.
+ *
+ * @param bytes
+ * @param longitud Número de bytes
+ * @param texto Buffer de al menos 8 * longitud caracteres
+ */
+void CodificarBits(const uint8_t* bytes, size_t longitud, char* texto) {
+  for (size_t i = longitud; i-- > 0;) {
+    const uint8_t byte = bytes[i];
+    std::memcpy(texto + 8 * i, kTablaExpansion[byte].bits, 8);
+  }
+}
+
+/**
+ * @brief Convierte texto binario a bytes.
+ *
+ * Lanza std::invalid_argument si la longitud no es múltiplo de 8 o aparece un
+ * carácter distinto de '0' y '1'; en ese caso el contenido de bytes queda
+ * indeterminado.
+ *
+ * @param texto
+ * @param longitud Número de caracteres
+ * @param bytes Buffer de al menos longitud / 8 bytes
+ */
+void DecodificarBits(const char* texto, size_t longitud, uint8_t* bytes) {
+  if (longitud % 8 != 0) {
+    throw std::invalid_argument("La cadena binaria debe tener una longitud múltiplo de 8");
+  }
+  kDecodificar(texto, longitud, bytes);
+}
@@ -0,0 +1,146 @@
+#include "../include/flujo.h"
+#include "../include/codec.h"
+#include "../include/vernam.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Lee hasta llenar el buffer o llegar al final de la entrada.
+ *
+ * Una tubería puede devolver lecturas parciales; se insiste para que todos los
+ * bloques salvo el último tengan el tamaño completo.
+ *
+ * @return size_t Bytes leídos (0 al final de la entrada)
+ */
+size_t LeerBloque(int fd, uint8_t* buffer, size_t tamano) {
+  size_t leidos = 0;
+  while (leidos < tamano) {
+    ssize_t n = read(fd, buffer + leidos, tamano - leidos);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Error de lectura: ") + std::strerror(errno));
+    }
+    if (n == 0) break;
+    leidos += static_cast<size_t>(n);
+  }
+  return leidos;
+}
+
+/**
+ * @brief Escribe el buffer completo, reintentando las escrituras parciales.
+ */
+void EscribirBloque(int fd, const uint8_t* buffer, size_t tamano) {
+  size_t escritos = 0;
+  while (escritos < tamano) {
+    ssize_t n = write(fd, buffer + escritos, tamano - escritos);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Error de escritura: ") + std::strerror(errno));
+    }
+    escritos += static_cast<size_t>(n);
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Cifra (o descifra) la entrada en bloques de tamaño fijo con un pad proyectado.
+ *
+ * Cada bloque se lee, se combina en el sitio con el pad a partir de
+ * desplazamiento y se escribe antes de leer el siguiente, de modo que la
+ * memoria usada es kTamanoBloque sea cual sea el tamaño de la entrada. Las
+ * páginas del pad ya consumidas se liberan al avanzar.
+ *
+ * @param entrada Descriptor de lectura (fichero o tubería)
+ * @param salida Descriptor de escritura
+ * @param pad
+ * @param desplazamiento Primer byte del pad que se usa
+ * @param maximo Bytes de pad utilizables (por ejemplo, los de una reserva)
+ * @return size_t Bytes procesados
+ */
+size_t CifrarFlujo(int entrada, int salida, ArchivoMapeado& pad, size_t desplazamiento, size_t maximo) {
+  if (desplazamiento > pad.Tamano()) {
+    throw std::invalid_argument("El desplazamiento supera el tamaño del pad");
+  }
+  const size_t disponible = std::min(maximo, pad.Tamano() - desplazamiento);
+  // Si la entrada es un fichero regular se comprueba el pad antes de escribir nada.
+  struct stat info;
+  if (fstat(entrada, &info) == 0 && S_ISREG(info.st_mode) && static_cast<size_t>(info.st_size) > disponible) {
+    throw std::invalid_argument("El pad es más corto que la entrada");
+  }
+  pad.AccesoSecuencial();
+
+  std::vector<uint8_t> bloque(kTamanoBloque);
+  size_t total = 0;
+  size_t leidos;
+  while ((leidos = LeerBloque(entrada, bloque.data(), bloque.size())) > 0) {
+    if (leidos > disponible - total) {
+      throw std::runtime_error("El pad se ha agotado antes del final de la entrada");
+    }
+    CifradoVerman(bloque.data(), pad.Datos() + desplazamiento + total, bloque.data(), leidos);
+    EscribirBloque(salida, bloque.data(), leidos);
+    pad.Liberar(desplazamiento + total, leidos);
+    total += leidos;
+  }
+  return total;
+}
+
+/**
+ * @brief Convierte la entrada a texto binario por bloques, en el sitio.
+ *
+ * Cada bloque lee kTamanoBloque / 8 bytes y los expande sobre el mismo buffer.
+ *
+ * @param entrada
+ * @param salida
+ * @return size_t Bytes convertidos
+ */
+size_t CodificarFlujo(int entrada, int salida) {
+  std::vector<uint8_t> bloque(kTamanoBloque);
+  size_t total = 0;
+  size_t leidos;
+  while ((leidos = LeerBloque(entrada, bloque.data(), bloque.size() / 8)) > 0) {
+    CodificarBits(bloque.data(), leidos, reinterpret_cast<char*>(bloque.data()));
+    EscribirBloque(salida, bloque.data(), leidos * 8);
+    total += leidos;
+  }
+  return total;
+}
+
+/**
+ * @brief Convierte texto binario a bytes por bloques, en el sitio.
+ *
+ * Los caracteres que no completan un byte pasan al bloque siguiente. Al final
+ * de la entrada solo se admite que sobren espacios o saltos de línea.
+ *
+ * @param entrada
+ * @param salida
+ * @return size_t Bytes obtenidos
+ */
+size_t DecodificarFlujo(int entrada, int salida) {
+  std::vector<uint8_t> bloque(kTamanoBloque);
+  char* texto = reinterpret_cast<char*>(bloque.data());
+  size_t total = 0, pendientes = 0;
+  size_t leidos;
+  while ((leidos = LeerBloque(entrada, bloque.data() + pendientes, bloque.size() - pendientes)) > 0) {
+    const size_t disponibles = pendientes + leidos;
+    const size_t utiles = disponibles / 8 * 8;
+    DecodificarBits(texto, utiles, bloque.data());
+    EscribirBloque(salida, bloque.data(), utiles / 8);
+    total += utiles / 8;
+    pendientes = disponibles - utiles;
+    std::memmove(texto, texto + utiles, pendientes);
+  }
+  if (std::string(texto, pendientes).find_first_not_of(" \t\r\n") != std::string::npos) {
+    throw std::invalid_argument("La cadena binaria debe tener una longitud múltiplo de 8");
+  }
+  return total;
+}
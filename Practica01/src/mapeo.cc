@@ -0,0 +1,115 @@
+#include "../include/mapeo.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Proyecta el fichero completo en memoria.
+ *
+ * @param ruta
+ * @param modo kLectura (privado, solo lectura) o kLecturaEscritura (compartido)
+ */
+ArchivoMapeado::ArchivoMapeado(const std::string& ruta, Modo modo)
+    : datos_(nullptr), tamano_(0), dispositivo_(0), inodo_(0) {
+  int fd = open(ruta.c_str(), modo == kLectura ? O_RDONLY : O_RDWR);
+  if (fd < 0) {
+    throw std::runtime_error("No se puede abrir " + ruta + ": " + std::strerror(errno));
+  }
+  struct stat info;
+  if (fstat(fd, &info) < 0) {
+    int error = errno;
+    close(fd);
+    throw std::runtime_error("No se puede consultar " + ruta + ": " + std::strerror(error));
+  }
+  tamano_ = static_cast<size_t>(info.st_size);
+  dispositivo_ = static_cast<uint64_t>(info.st_dev);
+  inodo_ = static_cast<uint64_t>(info.st_ino);
+  // mmap no admite longitud 0: un fichero vacío se queda sin proyección.
+  if (tamano_ > 0) {
+    int proteccion = modo == kLectura ? PROT_READ : PROT_READ | PROT_WRITE;
+    int flags = modo == kLectura ? MAP_PRIVATE : MAP_SHARED;
+    void* datos = mmap(nullptr, tamano_, proteccion, flags, fd, 0);
+    if (datos == MAP_FAILED) {
+      int error = errno;
+      close(fd);
+      throw std::runtime_error("No se puede proyectar " + ruta + ": " + std::strerror(error));
+    }
+    datos_ = static_cast<uint8_t*>(datos);
+  }
+  // La proyección sigue siendo válida tras cerrar el descriptor.
+  close(fd);
+}
+
+ArchivoMapeado::~ArchivoMapeado() {
+  if (datos_ != nullptr) munmap(datos_, tamano_);
+}
+
+/**
+ * @brief Indica al sistema que el fichero se recorrerá en orden (lectura anticipada).
+ */
+void ArchivoMapeado::AccesoSecuencial() {
+  if (datos_ != nullptr) madvise(datos_, tamano_, MADV_SEQUENTIAL);
+}
+
+/**
+ * @brief Descarta las páginas ya consumidas de [desplazamiento, desplazamiento + longitud).
+ *
+ * El inicio se redondea hacia abajo y el final hacia abajo a páginas, para que
+ * la página a caballo entre dos llamadas consecutivas también se libere. Si una
+ * página liberada se vuelve a leer, el sistema la carga de nuevo desde el
+ * fichero, por lo que la memoria residente se mantiene acotada al recorrer
+ * pads de gran tamaño.
+ *
+ * @param desplazamiento
+ * @param longitud
+ */
+void ArchivoMapeado::Liberar(size_t desplazamiento, size_t longitud) {
+  const size_t pagina = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  size_t inicio = desplazamiento / pagina * pagina;
+  size_t fin = (desplazamiento + longitud) / pagina * pagina;
+  if (datos_ != nullptr && inicio < fin && fin <= tamano_) {
+    madvise(datos_ + inicio, fin - inicio, MADV_DONTNEED);
+  }
+}
+
+/**
+ * @brief Indica si el descriptor es el fichero proyectado.
+ *
+ * Truncar ese fichero mientras está proyectado deja páginas sin respaldo:
+ * leerlas da ceros o SIGBUS.
+ *
+ * @param fd
+ */
+bool ArchivoMapeado::MismoArchivo(int fd) const {
+  struct stat info;
+  return fstat(fd, &info) == 0 && static_cast<uint64_t>(info.st_dev) == dispositivo_ &&
+         static_cast<uint64_t>(info.st_ino) == inodo_;
+}
+
+/**
+ * @brief Indica si dos descriptores son el mismo fichero regular (mismo dispositivo e inodo).
+ *
+ * Las rutas no bastan: "f", "./f" o un enlace duro llevan al mismo fichero.
+ *
+ * @param fd1
+ * @param fd2
+ * @return true Si abrir uno de ellos con O_TRUNC vaciaría el otro
+ */
+bool MismoArchivo(int fd1, int fd2) {
+  struct stat info1, info2;
+  if (fstat(fd1, &info1) < 0 || fstat(fd2, &info2) < 0) return false;
+  return S_ISREG(info1.st_mode) && info1.st_dev == info2.st_dev && info1.st_ino == info2.st_ino;
+}
+
+/**
+ * @brief Vuelca al fichero los cambios de una proyección de lectura/escritura.
+ */
+void ArchivoMapeado::Sincronizar() {
+  if (datos_ != nullptr) msync(datos_, tamano_, MS_SYNC);
+}
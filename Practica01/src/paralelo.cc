@@ -0,0 +1,114 @@
+#include "../include/paralelo.h"
+#include "../include/vernam.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Escribe el buffer completo en una posición del fichero.
+ */
+void EscribirEnPosicion(int fd, const uint8_t* buffer, size_t tamano, size_t posicion) {
+  size_t escritos = 0;
+  while (escritos < tamano) {
+    ssize_t n = pwrite(fd, buffer + escritos, tamano - escritos, static_cast<off_t>(posicion + escritos));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Error de escritura: ") + std::strerror(errno));
+    }
+    escritos += static_cast<size_t>(n);
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Cifra (o descifra) un fichero repartiendo trozos alineados entre varios hilos.
+ *
+ * En Vernam cada byte depende solo de su posición, así que el fichero se
+ * divide en trozos de kTamanoTrozo que los hilos toman de un contador
+ * compartido. Cada hilo combina su trozo de la entrada proyectada con el
+ * mismo rango del pad y lo escribe con pwrite en su posición, de modo que la
+ * salida queda en orden sin que los hilos se coordinen entre sí.
+ *
+ * @param ruta_entrada Fichero regular
+ * @param ruta_salida Se crea o se trunca; no puede ser la entrada ni el pad
+ * @param pad
+ * @param desplazamiento Primer byte del pad que se usa
+ * @param hilos 0 para usar todos los núcleos disponibles
+ * @return size_t Bytes procesados
+ */
+size_t CifrarParalelo(const std::string& ruta_entrada, const std::string& ruta_salida, ArchivoMapeado& pad,
+                      size_t desplazamiento, unsigned hilos) {
+  ArchivoMapeado entrada(ruta_entrada);
+  const size_t tamano = entrada.Tamano();
+  if (desplazamiento > pad.Tamano() || tamano > pad.Tamano() - desplazamiento) {
+    throw std::invalid_argument("El pad es más corto que la entrada");
+  }
+  if (hilos == 0) hilos = std::thread::hardware_concurrency();
+  if (hilos == 0) hilos = 1;
+
+  // Sin O_TRUNC: si la salida fuera la entrada o el pad, se vaciaría antes de leerlos.
+  int salida = open(ruta_salida.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (salida < 0) {
+    throw std::runtime_error("No se puede abrir " + ruta_salida + ": " + std::strerror(errno));
+  }
+  if (entrada.MismoArchivo(salida) || pad.MismoArchivo(salida)) {
+    close(salida);
+    throw std::invalid_argument("La salida no puede ser el fichero de entrada ni el pad");
+  }
+  // Se fija el tamaño final para que las escrituras posicionadas no dependan del orden.
+  if (ftruncate(salida, static_cast<off_t>(tamano)) < 0) {
+    int error = errno;
+    close(salida);
+    throw std::runtime_error("No se puede redimensionar " + ruta_salida + ": " + std::strerror(error));
+  }
+
+  const size_t trozos = (tamano + kTamanoTrozo - 1) / kTamanoTrozo;
+  std::atomic<size_t> siguiente(0);
+  std::atomic<bool> fallo(false);
+  std::exception_ptr error;
+
+  auto trabajador = [&]() {
+    try {
+      std::vector<uint8_t> buffer(kTamanoTrozo);
+      size_t trozo;
+      while (!fallo.load(std::memory_order_relaxed) &&
+             (trozo = siguiente.fetch_add(1, std::memory_order_relaxed)) < trozos) {
+        const size_t inicio = trozo * kTamanoTrozo;
+        const size_t longitud = std::min(kTamanoTrozo, tamano - inicio);
+        CifradoVerman(entrada.Datos() + inicio, pad.Datos() + desplazamiento + inicio, buffer.data(), longitud);
+        EscribirEnPosicion(salida, buffer.data(), longitud, inicio);
+      }
+    } catch (...) {
+      // Solo el primer hilo que falla guarda su excepción; el resto termina al ver fallo.
+      if (!fallo.exchange(true)) error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> trabajadores;
+  try {
+    for (unsigned i = 1; i < hilos && i < trozos; ++i) trabajadores.emplace_back(trabajador);
+  } catch (...) {
+    // No se pudo crear un hilo: los ya creados terminan al ver fallo y se unen abajo.
+    if (!fallo.exchange(true)) error = std::current_exception();
+  }
+  trabajador();
+  for (std::thread& hilo : trabajadores) hilo.join();
+
+  if (close(salida) < 0 && !error) {
+    throw std::runtime_error("Error al cerrar " + ruta_salida + ": " + std::strerror(errno));
+  }
+  if (error) std::rethrow_exception(error);
+  return tamano;
+}
@@ -0,0 +1,61 @@
+#include "../include/vernam.h"
+#include "../include/codec.h"
+#include "../include/xor.h"
+
+#include <stdexcept>
+
+/**
+ * @brief Cifrado de Vernam sobre buffers empaquetados.
+ *
+ * Cada byte contiene 8 bits del mensaje. El XOR lo hace el kernel masivo
+ * (SSE2/AVX2/AVX-512 o portable, según la CPU). Cifrar y descifrar son la
+ * misma operación. Admite cifrado == mensaje.
+ *
+ * @param mensaje
+ * @param clave
+ * @param cifrado
+ * @param longitud Número de bytes
+ */
+void CifradoVerman(const uint8_t* mensaje, const uint8_t* clave, uint8_t* cifrado, size_t longitud) {
+  XorBuffers(mensaje, clave, cifrado, longitud);
+}
+
+/**
+ * @brief Cifrado de Vernam sobre vectores de bytes.
+ *
+ * @param mensaje
+ * @param clave Debe tener la misma longitud que el mensaje
+ * @return std::vector<uint8_t>
+ */
+std::vector<uint8_t> CifradoVerman(const std::vector<uint8_t>& mensaje, const std::vector<uint8_t>& clave) {
+  if (mensaje.size() != clave.size()) {
+    throw std::invalid_argument("Mensaje y clave no tienen misma longitud");
+  }
+  std::vector<uint8_t> cifrado(mensaje.size());
+  CifradoVerman(mensaje.data(), clave.data(), cifrado.data(), mensaje.size());
+  return cifrado;
+}
+
+/**
+ * @brief Convierte un texto a su representación en bits ('0'/'1'), 8 por carácter.
+ *
+ * @param mensaje
+ * @return std::string
+ */
+std::string ConvertirBinario(const std::string& mensaje) {
+  std::string binario(mensaje.size() * 8, '\0');
+  CodificarBits(reinterpret_cast<const uint8_t*>(mensaje.data()), mensaje.size(), &binario[0]);
+  return binario;
+}
+
+/**
+ * @brief Convierte una cadena de bits ('0'/'1') a los bytes que representa.
+ *
+ * @param cifrado Longitud múltiplo de 8
+ * @return std::string
+ */
+std::string CifradoASCII(const std::string& cifrado) {
+  std::string ascii(cifrado.size() / 8, '\0');
+  DecodificarBits(cifrado.data(), cifrado.size(), reinterpret_cast<uint8_t*>(&ascii[0]));
+  return ascii;
+}
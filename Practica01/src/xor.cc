@@ -0,0 +1,207 @@
+#include "../include/xor.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VERNAM_X86 1
+#endif
+
+namespace {
+
+/**
+ * @brief Implementación portable: XOR de una palabra de 64 bits por iteración.
+ *
+ * @param a
+ * @param b
+ * @param salida
+ * @param longitud
+ */
+void XorPortable(const uint8_t* a, const uint8_t* b, uint8_t* salida, size_t longitud) {
+  size_t i = 0;
+  // memcpy evita accesos desalineados y el compilador lo traduce a una carga simple.
+  for (; i + sizeof(uint64_t) <= longitud; i += sizeof(uint64_t)) {
+    uint64_t x, y;
+    std::memcpy(&x, a + i, sizeof(x));
+    std::memcpy(&y, b + i, sizeof(y));
+    x ^= y;
+    std::memcpy(salida + i, &x, sizeof(x));
+  }
+  for (; i < longitud; ++i) {
+    salida[i] = a[i] ^ b[i];
+  }
+}
+
+#ifdef VERNAM_X86
+
+/**
+ * @brief Decide si conviene escribir sin pasar por la caché.
+ *
+ * Solo compensa con buffers grandes y salida distinta de las entradas: en el
+ * sitio la línea ya se ha leído y el almacenamiento no temporal no ahorra nada.
+ */
+bool UsarNoTemporal(const uint8_t* a, const uint8_t* b, const uint8_t* salida, size_t longitud) {
+  return longitud >= kUmbralNoTemporal && salida != a && salida != b;
+}
+
+/**
+ * @brief Implementación SSE2: 4 registros de 16 bytes (64 bytes) por iteración.
+ */
+__attribute__((target("sse2")))
+void XorSse2(const uint8_t* a, const uint8_t* b, uint8_t* salida, size_t longitud) {
+  size_t i = 0;
+  for (; i + 64 <= longitud; i += 64) {
+    __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16));
+    __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 32));
+    __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 48));
+    x0 = _mm_xor_si128(x0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+    x1 = _mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16)));
+    x2 = _mm_xor_si128(x2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 32)));
+    x3 = _mm_xor_si128(x3, _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 48)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(salida + i), x0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(salida + i + 16), x1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(salida + i + 32), x2);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(salida + i + 48), x3);
+  }
+  for (; i + 16 <= longitud; i += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    x = _mm_xor_si128(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(salida + i), x);
+  }
+  XorPortable(a + i, b + i, salida + i, longitud - i);
+}
+
+/**
+ * @brief Implementación AVX2: 4 registros de 32 bytes (128 bytes) por iteración.
+ *
+ * Para buffers grandes fuera del sitio se alinea la salida a 32 bytes y se
+ * escribe con almacenamientos no temporales.
+ */
+__attribute__((target("avx2")))
+void XorAvx2(const uint8_t* a, const uint8_t* b, uint8_t* salida, size_t longitud) {
+  size_t i = 0;
+  const bool no_temporal = UsarNoTemporal(a, b, salida, longitud);
+  if (no_temporal) {
+    // Bytes necesarios hasta que la salida quede alineada a 32.
+    i = (32 - (reinterpret_cast<uintptr_t>(salida) & 31)) & 31;
+    XorPortable(a, b, salida, i);
+  }
+  for (; i + 128 <= longitud; i += 128) {
+    __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 32));
+    __m256i x2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 64));
+    __m256i x3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 96));
+    x0 = _mm256_xor_si256(x0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+    x1 = _mm256_xor_si256(x1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 32)));
+    x2 = _mm256_xor_si256(x2, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 64)));
+    x3 = _mm256_xor_si256(x3, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 96)));
+    if (no_temporal) {
+      _mm256_stream_si256(reinterpret_cast<__m256i*>(salida + i), x0);
+      _mm256_stream_si256(reinterpret_cast<__m256i*>(salida + i + 32), x1);
+      _mm256_stream_si256(reinterpret_cast<__m256i*>(salida + i + 64), x2);
+      _mm256_stream_si256(reinterpret_cast<__m256i*>(salida + i + 96), x3);
+    } else {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(salida + i), x0);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(salida + i + 32), x1);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(salida + i + 64), x2);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(salida + i + 96), x3);
+    }
+  }
+  if (no_temporal) _mm_sfence();
+  for (; i + 32 <= longitud; i += 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    x = _mm256_xor_si256(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(salida + i), x);
+  }
+  XorPortable(a + i, b + i, salida + i, longitud - i);
+}
+
+/**
+ * @brief Implementación AVX-512: 4 registros de 64 bytes (256 bytes) por iteración.
+ *
+ * Igual que la AVX2, con almacenamientos no temporales para buffers grandes.
+ */
+__attribute__((target("avx512f")))
+void XorAvx512(const uint8_t* a, const uint8_t* b, uint8_t* salida, size_t longitud) {
+  size_t i = 0;
+  const bool no_temporal = UsarNoTemporal(a, b, salida, longitud);
+  if (no_temporal) {
+    i = (64 - (reinterpret_cast<uintptr_t>(salida) & 63)) & 63;
+    XorPortable(a, b, salida, i);
+  }
+  for (; i + 256 <= longitud; i += 256) {
+    __m512i x0 = _mm512_loadu_si512(a + i);
+    __m512i x1 = _mm512_loadu_si512(a + i + 64);
+    __m512i x2 = _mm512_loadu_si512(a + i + 128);
+    __m512i x3 = _mm512_loadu_si512(a + i + 192);
+    x0 = _mm512_xor_si512(x0, _mm512_loadu_si512(b + i));
+    x1 = _mm512_xor_si512(x1, _mm512_loadu_si512(b + i + 64));
+    x2 = _mm512_xor_si512(x2, _mm512_loadu_si512(b + i + 128));
+    x3 = _mm512_xor_si512(x3, _mm512_loadu_si512(b + i + 192));
+    if (no_temporal) {
+      _mm512_stream_si512(reinterpret_cast<__m512i*>(salida + i), x0);
+      _mm512_stream_si512(reinterpret_cast<__m512i*>(salida + i + 64), x1);
+      _mm512_stream_si512(reinterpret_cast<__m512i*>(salida + i + 128), x2);
+      _mm512_stream_si512(reinterpret_cast<__m512i*>(salida + i + 192), x3);
+    } else {
+      _mm512_storeu_si512(salida + i, x0);
+      _mm512_storeu_si512(salida + i + 64, x1);
+      _mm512_storeu_si512(salida + i + 128, x2);
+      _mm512_storeu_si512(salida + i + 192, x3);
+    }
+  }
+  if (no_temporal) _mm_sfence();
+  for (; i + 64 <= longitud; i += 64) {
+    __m512i x = _mm512_xor_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+    _mm512_storeu_si512(salida + i, x);
+  }
+  XorPortable(a + i, b + i, salida + i, longitud - i);
+}
+
+#endif  // VERNAM_X86
+
+/**
+ * @brief Elige la implementación más ancha que soporta la CPU (consulta CPUID).
+ *
+ * @return ImplementacionXor
+ */
+ImplementacionXor SeleccionarXor() {
+  std::vector<ImplementacionXor> disponibles = ImplementacionesXor();
+  return disponibles.back();
+}
+
+// Se resuelve una única vez al arrancar el programa.
+const ImplementacionXor kXorActivo = SeleccionarXor();
+
+}  // namespace
+
+/**
+ * @brief XOR masivo: salida = a ^ b, con la implementación elegida al arrancar.
+ *
+ * @param a
+ * @param b
+ * @param salida
+ * @param longitud
+ */
+void XorBuffers(const uint8_t* a, const uint8_t* b, uint8_t* salida, size_t longitud) {
+  kXorActivo.funcion(a, b, salida, longitud);
+}
+
+const char* NombreXorActivo() { return kXorActivo.nombre; }
+
+/**
+ * @brief Lista las implementaciones soportadas, de la más sencilla a la más ancha.
+ *
+ * @return std::vector<ImplementacionXor>
+ */
+std::vector<ImplementacionXor> ImplementacionesXor() {
+  std::vector<ImplementacionXor> lista = {{"portable", XorPortable}};
+#ifdef VERNAM_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) lista.push_back({"sse2", XorSse2});
+  if (__builtin_cpu_supports("avx2")) lista.push_back({"avx2", XorAvx2});
+  if (__builtin_cpu_supports("avx512f")) lista.push_back({"avx512", XorAvx512});
+#endif
+  return lista;
+}
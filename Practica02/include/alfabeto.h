@@ -0,0 +1,209 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include "vigenere.h"
+
+/**
+ * @brief Políticas de alfabeto: las letras en orden, en mayúsculas y minúsculas.
+ *
+ * Los caracteres son bytes sueltos; la Ñ del castellano se representa en
+ * Latin-1 (0xD1 y 0xF1), de modo que cada letra sigue ocupando un byte.
+ */
+struct AlfabetoLatino {
+  static constexpr char kMayusculas[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  static constexpr char kMinusculas[] = "abcdefghijklmnopqrstuvwxyz";
+};
+
+struct AlfabetoCastellano {
+  static constexpr char kMayusculas[] = "ABCDEFGHIJKLMN\xD1OPQRSTUVWXYZ";
+  static constexpr char kMinusculas[] = "abcdefghijklmn\xF1opqrstuvwxyz";
+};
+
+/**
+ * @brief Tablas de un alfabeto generadas en compilación.
+ *
+ * - kIndice: posición (0..N-1) de cada byte en el alfabeto; 0 si no es letra.
+ * - kEsLetra: 1 si el byte es una letra del alfabeto, 0 si no.
+ * - kTabula: tabula recta, kTabula[k][t] es la letra (t + k) mod N.
+ * - kInversa: kInversa[k][c] es la letra (c - k) mod N.
+ *
+ * No dependen del locale: un byte es letra solo si aparece en la política.
+ */
+template <typename Politica>
+struct TablasAlfabeto {
+  static constexpr size_t kTamano = sizeof(Politica::kMayusculas) - 1;
+  using Tabla = std::array<std::array<char, kTamano>, kTamano>;
+
+  static constexpr std::array<uint8_t, 256> GenerarIndice() {
+    std::array<uint8_t, 256> indice = {};
+    for (size_t i = 0; i < kTamano; ++i) {
+      indice[static_cast<unsigned char>(Politica::kMayusculas[i])] = static_cast<uint8_t>(i);
+      indice[static_cast<unsigned char>(Politica::kMinusculas[i])] = static_cast<uint8_t>(i);
+    }
+    return indice;
+  }
+
+  static constexpr std::array<uint8_t, 256> GenerarEsLetra() {
+    std::array<uint8_t, 256> es_letra = {};
+    for (size_t i = 0; i < kTamano; ++i) {
+      es_letra[static_cast<unsigned char>(Politica::kMayusculas[i])] = 1;
+      es_letra[static_cast<unsigned char>(Politica::kMinusculas[i])] = 1;
+    }
+    return es_letra;
+  }
+
+  static constexpr Tabla GenerarTabla(bool inversa) {
+    Tabla tabla = {};
+    for (size_t k = 0; k < kTamano; ++k) {
+      for (size_t t = 0; t < kTamano; ++t) {
+        tabla[k][t] = Politica::kMayusculas[inversa ? (t + kTamano - k) % kTamano : (t + k) % kTamano];
+      }
+    }
+    return tabla;
+  }
+
+  static constexpr std::array<uint8_t, 256> kIndice = GenerarIndice();
+  static constexpr std::array<uint8_t, 256> kEsLetra = GenerarEsLetra();
+  static constexpr Tabla kTabula = GenerarTabla(false);
+  static constexpr Tabla kInversa = GenerarTabla(true);
+};
+
+/**
+ * @brief Comprueba que la clave no está vacía y solo contiene letras del alfabeto.
+ *
+ * @tparam Politica
+ * @param clave
+ */
+template <typename Politica>
+void ComprobarClaveAlfabeto(const std::string& clave) {
+  if (clave.empty()) throw std::invalid_argument("La clave no puede estar vacía");
+  for (char c : clave) {
+    if (!TablasAlfabeto<Politica>::kEsLetra[static_cast<unsigned char>(c)]) {
+      throw std::invalid_argument("La clave solo puede contener letras");
+    }
+  }
+}
+
+/**
+ * @brief Cuenta las letras del alfabeto que hay en el texto.
+ *
+ * @tparam Politica
+ * @param texto
+ * @param longitud
+ * @return size_t
+ */
+template <typename Politica>
+size_t ContarLetras(const char* texto, size_t longitud) {
+  size_t letras = 0;
+  for (size_t i = 0; i < longitud; ++i) {
+    letras += TablasAlfabeto<Politica>::kEsLetra[static_cast<unsigned char>(texto[i])];
+  }
+  return letras;
+}
+
+/**
+ * @brief Recorrido único del texto con búsquedas en tabla y sin saltos por carácter.
+ *
+ * Cada carácter se escribe siempre en la posición actual de la salida y el
+ * índice solo avanza si era una letra (lo que no es letra se sobrescribe con
+ * el siguiente). Igual con el espacio de los bloques y con la fase de la
+ * clave: los contadores avanzan sumando kEsLetra en lugar de comprobarlo.
+ *
+ * Las escrituras que no avanzan caen en la posición del siguiente carácter
+ * de salida, así que no hace falta más buffer que para el resultado.
+ *
+ * @return size_t Caracteres escritos
+ */
+template <typename Politica, Operacion kOperacion>
+size_t RecorrerAlfabeto(const char* texto, size_t longitud, const std::string& clave, char* salida,
+                        size_t tamano_bloque, EstadoVigenere& estado) {
+  using Tablas = TablasAlfabeto<Politica>;
+  const size_t longitud_clave = clave.size();
+  const size_t con_bloques = tamano_bloque != 0;
+  size_t escritos = 0, fase = estado.fase, en_bloque = estado.en_bloque;
+  for (size_t i = 0; i < longitud; ++i) {
+    const unsigned char c = static_cast<unsigned char>(texto[i]);
+    const size_t es_letra = Tablas::kEsLetra[c];
+    const uint8_t valor_texto = Tablas::kIndice[c];
+    const uint8_t valor_clave = Tablas::kIndice[static_cast<unsigned char>(clave[fase])];
+
+    const size_t lleno = es_letra & con_bloques & (en_bloque == tamano_bloque);
+    salida[escritos] = ' ';
+    escritos += lleno;
+    en_bloque = (en_bloque & (lleno - 1)) + (es_letra & con_bloques);
+
+    if (kOperacion == Operacion::kCifrar) {
+      salida[escritos] = Tablas::kTabula[valor_clave][valor_texto];
+    } else if (kOperacion == Operacion::kDescifrar) {
+      salida[escritos] = Tablas::kInversa[valor_clave][valor_texto];
+    } else {
+      // (clave - texto) mod N: la inversa con los papeles cambiados.
+      salida[escritos] = Tablas::kInversa[valor_texto][valor_clave];
+    }
+    escritos += es_letra;
+    fase += es_letra;
+    fase = fase == longitud_clave ? 0 : fase;
+  }
+  estado.fase = fase;
+  estado.en_bloque = en_bloque;
+  return escritos;
+}
+
+/**
+ * @brief Núcleo de Vigenère para cualquier alfabeto, con la firma de FuncionVigenere.
+ *
+ * @tparam Politica
+ * @param salida Buffer de al menos CapacidadSalida(longitud, tamano_bloque) caracteres
+ * @return size_t Caracteres escritos en salida
+ */
+template <typename Politica>
+size_t ProcesarVigenereAlfabeto(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                                char* salida, size_t tamano_bloque, EstadoVigenere& estado) {
+  ComprobarClaveAlfabeto<Politica>(clave);
+  if (estado.fase >= clave.size()) throw std::invalid_argument("La fase no cabe en la clave");
+  switch (operacion) {
+    case Operacion::kCifrar:
+      return RecorrerAlfabeto<Politica, Operacion::kCifrar>(texto, longitud, clave, salida, tamano_bloque, estado);
+    case Operacion::kDescifrar:
+      return RecorrerAlfabeto<Politica, Operacion::kDescifrar>(texto, longitud, clave, salida, tamano_bloque,
+                                                               estado);
+    case Operacion::kModificacion:
+      return RecorrerAlfabeto<Politica, Operacion::kModificacion>(texto, longitud, clave, salida, tamano_bloque,
+                                                                  estado);
+  }
+  return 0;
+}
+
+/**
+ * @brief Ejecuta el núcleo de un alfabeto sobre un std::string.
+ */
+template <typename Politica>
+std::string ProcesarTextoAlfabeto(const std::string& texto, const std::string& clave, Operacion operacion,
+                                  size_t tamano_bloque) {
+  std::string salida(CapacidadSalida(texto.size(), tamano_bloque), '\0');
+  EstadoVigenere estado;
+  salida.resize(ProcesarVigenereAlfabeto<Politica>(texto.data(), texto.size(), clave, operacion, &salida[0],
+                                                   tamano_bloque, estado));
+  return salida;
+}
+
+// Versiones de CifrarVigenere, DescifrarVigenere y CifradoModificacion para
+// cualquier alfabeto, p. ej. CifrarVigenere<AlfabetoCastellano>(texto, clave).
+template <typename Politica>
+std::string CifrarVigenere(const std::string& texto, const std::string& clave) {
+  return ProcesarTextoAlfabeto<Politica>(texto, clave, Operacion::kCifrar, clave.size());
+}
+
+template <typename Politica>
+std::string DescifrarVigenere(const std::string& cifrado, const std::string& clave) {
+  return ProcesarTextoAlfabeto<Politica>(cifrado, clave, Operacion::kDescifrar, clave.size());
+}
+
+template <typename Politica>
+std::string CifradoModificacion(const std::string& texto, const std::string& clave) {
+  return ProcesarTextoAlfabeto<Politica>(texto, clave, Operacion::kModificacion, 0);
+}
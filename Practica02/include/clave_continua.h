@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "mapeo.h"
+#include "vigenere.h"
+
+// Letras por bloque de la salida con clave continua (la clave no tiene una longitud que usar).
+const size_t kBloqueClaveContinua = 5;
+
+/**
+ * @brief Clave continua (running key): las letras de un libro proyectado en memoria.
+ *
+ * En lugar de repetir una clave corta, cada letra del texto se combina con la
+ * siguiente letra del libro, leída directamente de la proyección: la clave
+ * nunca se copia a un std::string tan largo como el texto. Las páginas del
+ * libro ya consumidas se liberan al avanzar, así que la memoria residente no
+ * crece con el tamaño del documento.
+ */
+class ClaveContinua {
+ public:
+  explicit ClaveContinua(const std::string& ruta_libro, size_t desplazamiento = 0);
+
+  size_t Procesar(const char* texto, size_t longitud, Operacion operacion, char* salida, size_t tamano_bloque,
+                  EstadoVigenere& estado);
+
+  // Byte del libro por el que va la clave; sirve como desplazamiento del siguiente mensaje.
+  size_t Posicion() const { return posicion_; }
+  const ArchivoMapeado& Libro() const { return libro_; }
+
+ private:
+  ArchivoMapeado libro_;
+  size_t posicion_;
+  size_t liberado_;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Longitud de clave máxima que se prueba si no se indica otra.
+const size_t kLongitudMaximaClave = 20;
+// Letras mínimas por hilo para que merezca la pena repartir un único texto.
+const size_t kLetrasMinimasPorHilo = 1 << 20;
+// Número de trigramas distintos (26^3), índice de la tabla de Kasiski.
+const size_t kTrigramas = 26 * 26 * 26;
+
+/**
+ * @brief Resultado del análisis de la longitud de clave de un texto cifrado.
+ *
+ * Los vectores se indexan por longitud candidata L (1..longitud_maxima); la
+ * posición 0 no se usa.
+ */
+struct AnalisisLongitud {
+  size_t letras = 0;
+  // Friedman: índice de coincidencia medio de las L columnas del texto.
+  std::vector<double> indice_coincidencia;
+  // Kasiski: distancias entre trigramas repetidos consecutivos que son múltiplo de L.
+  std::vector<uint64_t> kasiski;
+  // Estimación clásica de Friedman a partir del índice de todo el texto.
+  double estimacion_friedman = 0.0;
+  size_t longitud_estimada = 0;
+};
+
+// Totales de un lote, sumados a partir de los histogramas de cada hilo.
+struct ResumenLote {
+  std::array<uint64_t, 26> frecuencias = {};
+  std::vector<uint64_t> por_longitud;  // Textos cuya longitud estimada es L
+  uint64_t letras = 0;
+};
+
+// Tablas de frecuencias con las que se puntúan las columnas.
+enum class Idioma { kCastellano, kIngles };
+
+// Clave candidata y su puntuación: suma de la chi-cuadrado de cada columna (menor es mejor).
+struct ClaveCandidata {
+  std::string clave;
+  double puntuacion;
+};
+
+AnalisisLongitud AnalizarLongitud(const std::string& cifrado, size_t longitud_maxima = kLongitudMaximaClave,
+                                  unsigned hilos = 0);
+std::vector<AnalisisLongitud> AnalizarLote(const std::vector<std::string>& cifrados,
+                                           size_t longitud_maxima = kLongitudMaximaClave, unsigned hilos = 0,
+                                           ResumenLote* resumen = nullptr);
+
+std::vector<ClaveCandidata> RecuperarClave(const std::string& cifrado, size_t longitud_clave, size_t mejores = 1,
+                                           Idioma idioma = Idioma::kCastellano);
+std::vector<std::vector<ClaveCandidata>> RecuperarLote(const std::vector<std::string>& cifrados,
+                                                       size_t longitud_clave, size_t mejores = 1,
+                                                       Idioma idioma = Idioma::kCastellano, unsigned hilos = 0);
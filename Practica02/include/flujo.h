@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "clave_continua.h"
+#include "vigenere.h"
+
+// Bytes de entrada que se leen y procesan en cada iteración del modo flujo.
+const size_t kTamanoTrozoFlujo = 1 << 20;
+
+size_t ProcesarFlujo(int entrada, int salida, const std::string& clave, Operacion operacion,
+                     size_t tamano_bloque, FuncionVigenere nucleo = ProcesarVigenere);
+size_t ProcesarFlujo(int entrada, int salida, ClaveContinua& clave, Operacion operacion, size_t tamano_bloque);
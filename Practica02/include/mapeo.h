@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Fichero proyectado en memoria con mmap (RAII).
+ *
+ * Se usa para los textos grandes: el contenido se lee en el sitio, sin
+ * copiarlo a un buffer propio, y el sistema solo carga las páginas que se tocan.
+ */
+class ArchivoMapeado {
+ public:
+  enum Modo { kLectura, kLecturaEscritura };
+
+  ArchivoMapeado(const std::string& ruta, Modo modo = kLectura);
+  ~ArchivoMapeado();
+
+  ArchivoMapeado(const ArchivoMapeado&) = delete;
+  ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+  const uint8_t* Datos() const { return datos_; }
+  uint8_t* Datos() { return datos_; }
+  size_t Tamano() const { return tamano_; }
+  bool MismoArchivo(int fd) const;
+
+  void AccesoSecuencial();
+  void Liberar(size_t desplazamiento, size_t longitud);
+  void Sincronizar();
+
+ private:
+  uint8_t* datos_;
+  size_t tamano_;
+  uint64_t dispositivo_;  // Para reconocer el fichero aunque ya no haya descriptor
+  uint64_t inodo_;
+};
+
+bool MismoArchivo(int fd1, int fd2);
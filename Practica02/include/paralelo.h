@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "alfabeto.h"
+#include "vigenere.h"
+
+// Bytes de entrada de cada segmento que reparten los hilos.
+const size_t kTamanoSegmento = 4 << 20;
+
+// Recuento de letras del mismo alfabeto que el núcleo, para la pasada previa.
+using FuncionContarLetras = size_t (*)(const char* texto, size_t longitud);
+
+size_t ProcesarParalelo(const std::string& ruta_entrada, const std::string& ruta_salida, const std::string& clave,
+                        Operacion operacion, size_t tamano_bloque, unsigned hilos = 0,
+                        FuncionVigenere nucleo = ProcesarVigenere,
+                        FuncionContarLetras contar = ContarLetras<AlfabetoLatino>);
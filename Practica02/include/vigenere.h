@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Operaciones que comparten el mismo recorrido del texto.
+enum class Operacion {
+  kCifrar,        // (texto + clave) mod 26
+  kDescifrar,     // (texto - clave) mod 26
+  kModificacion   // (clave - texto) mod 26
+};
+
+// Posición dentro de la clave y del bloque de salida. Conservarlo entre
+// llamadas permite procesar un texto por trozos con el mismo resultado.
+struct EstadoVigenere {
+  size_t fase = 0;       // Letras consumidas, módulo la longitud de la clave
+  size_t en_bloque = 0;  // Letras escritas en el bloque actual
+};
+
+// Firma común de las implementaciones del núcleo (escalar, SSE, AVX2).
+using FuncionVigenere = size_t (*)(const char* texto, size_t longitud, const std::string& clave,
+                                   Operacion operacion, char* salida, size_t tamano_bloque,
+                                   EstadoVigenere& estado);
+
+struct ImplementacionVigenere {
+  const char* nombre;
+  FuncionVigenere funcion;
+};
+
+// Lanza std::invalid_argument si la clave está vacía o no son solo letras.
+void ComprobarClave(const std::string& clave);
+
+// Núcleo: una sola pasada sobre el texto, escribiendo en un buffer ya reservado.
+// Usa la mejor implementación disponible, elegida al arrancar según CPUID.
+size_t CapacidadSalida(size_t longitud_texto, size_t tamano_bloque);
+size_t ProcesarVigenere(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                        char* salida, size_t tamano_bloque);
+size_t ProcesarVigenere(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                        char* salida, size_t tamano_bloque, EstadoVigenere& estado);
+size_t ProcesarVigenereEscalar(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                               char* salida, size_t tamano_bloque, EstadoVigenere& estado);
+
+// Implementaciones soportadas por la CPU actual (la escalar siempre está).
+std::vector<ImplementacionVigenere> ImplementacionesVigenere();
+const char* NombreVigenereActivo();
+
+std::string CifrarVigenere(const std::string& texto, const std::string& clave);
+std::string DescifrarVigenere(const std::string& cifrado, const std::string& clave);
+std::string CifradoModificacion(const std::string& texto, const std::string& clave);
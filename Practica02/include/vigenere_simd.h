@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "vigenere.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define VIGENERE_X86 1
+
+// Núcleos vectoriales: compactan las letras de cada tesela del texto y las
+// combinan con la clave 16 (SSE) o 32 (AVX2) a la vez.
+size_t ProcesarVigenereSse(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                           char* salida, size_t tamano_bloque, EstadoVigenere& estado);
+size_t ProcesarVigenereAvx2(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                            char* salida, size_t tamano_bloque, EstadoVigenere& estado);
+#endif
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../include/paralelo.h"
+#include "../include/vigenere.h"
+
+// Implementación anterior (tres pasadas y concatenación carácter a carácter),
+// conservada solo como referencia para comparar.
+namespace original {
+
+std::string AjustarClave(const std::string &texto, const std::string &clave) {
+  std::string claveAjustada;
+  int j = 0;
+  for (char c : texto) {
+    if (isalpha(c)) {
+      claveAjustada += toupper(clave[j % clave.size()]);
+      j++;
+    } else {
+      claveAjustada += c;
+    }
+  }
+  return claveAjustada;
+}
+
+std::string FormatearEnBloques(const std::string &texto, int tamanoBloque) {
+  std::string textoFormateado;
+  int contador = 0;
+  for (char c : texto) {
+    if (isalpha(c)) {
+      if (contador > 0 && contador % tamanoBloque == 0) {
+        textoFormateado += ' ';
+      }
+      textoFormateado += c;
+      contador++;
+    }
+  }
+  return textoFormateado;
+}
+
+std::string CifrarVigenere(const std::string &texto, const std::string &clave) {
+  std::string claveAjustada = AjustarClave(texto, clave);
+  std::string cifrado;
+  for (size_t i = 0; i < texto.size(); ++i) {
+    if (isalpha(texto[i])) {
+      cifrado += char(((toupper(texto[i]) - 'A' + toupper(claveAjustada[i]) - 'A') % 26) + 'A');
+    }
+  }
+  return FormatearEnBloques(cifrado, clave.size());
+}
+
+std::string DescifrarVigenere(const std::string &cifrado, const std::string &clave) {
+  std::string claveAjustada = AjustarClave(cifrado, clave);
+  std::string descifrado;
+  for (size_t i = 0; i < cifrado.size(); ++i) {
+    if (isalpha(cifrado[i])) {
+      descifrado += char(((toupper(cifrado[i]) - toupper(claveAjustada[i]) + 26) % 26) + 'A');
+    }
+  }
+  return FormatearEnBloques(descifrado, clave.size());
+}
+
+std::string CifradoModificacion(std::string texto, std::string clave) {
+  std::string cifrado = "", claveAjustada = AjustarClave(texto, clave);
+  for (size_t i = 0; i < texto.size(); ++i) {
+    if (isalpha(texto[i])) {
+      int resta_valores = (toupper(claveAjustada[i]) - 'A') - (toupper(texto[i]) - 'A');
+      if (resta_valores < 0) resta_valores += 26;
+      cifrado += char((resta_valores % 26) + 'A');
+    }
+  }
+  return cifrado;
+}
+
+}  // namespace original
+
+// Bytes mínimos a procesar por medida, para que los tamaños pequeños no den ruido.
+const size_t kBytesPorMedida = size_t(64) << 20;
+
+/**
+ * @brief Genera un texto con letras, espacios y signos de puntuación.
+ *
+ * @param longitud
+ * @return std::string
+ */
+std::string GenerarTexto(size_t longitud) {
+  const std::string palabras[] = {"Los ", "mensajes ", "secretos ", "viajan, ", "de ", "noche ",
+                                  "por ", "el ", "canal. ", "Nadie ", "lo ", "sabe; ", "ni ", "Eva!\n"};
+  std::string texto;
+  texto.reserve(longitud + 16);
+  for (size_t i = 0; texto.size() < longitud; i = i * 7 + 3) texto += palabras[i % 14];
+  texto.resize(longitud);
+  return texto;
+}
+
+/**
+ * @brief Repite una función hasta procesar kBytesPorMedida y devuelve los MB/s.
+ */
+template <typename Funcion>
+double Medir(size_t longitud, Funcion funcion) {
+  size_t repeticiones = kBytesPorMedida / longitud;
+  if (repeticiones == 0) repeticiones = 1;
+  size_t control = funcion();
+  auto inicio = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < repeticiones; ++r) control += funcion();
+  std::chrono::duration<double> segundos = std::chrono::steady_clock::now() - inicio;
+  // control evita que el compilador descarte las llamadas.
+  if (control == 0) std::cerr << "";
+  return double(longitud) * double(repeticiones) / segundos.count() / 1e6;
+}
+
+/**
+ * @brief MB/s de cada núcleo frente a la implementación anterior, por tamaño de texto.
+ *
+ * @param maximo Tamaño del texto más grande
+ */
+void BenchmarkNucleos(size_t maximo) {
+  const std::string clave = "CLAVESECRETA";
+  const std::string texto = GenerarTexto(maximo);
+  std::vector<char> salida(CapacidadSalida(maximo, clave.size()));
+  std::vector<ImplementacionVigenere> implementaciones = ImplementacionesVigenere();
+
+  struct Caso {
+    const char* nombre;
+    Operacion operacion;
+    size_t tamano_bloque;
+    std::string (*original)(const std::string&, const std::string&);
+  };
+  const Caso casos[] = {
+      {"Cifrar", Operacion::kCifrar, clave.size(), original::CifrarVigenere},
+      {"Descifrar", Operacion::kDescifrar, clave.size(), original::DescifrarVigenere},
+      {"Modificación", Operacion::kModificacion, 0,
+       [](const std::string& t, const std::string& k) { return original::CifradoModificacion(t, k); }},
+  };
+
+  std::cout << "Implementación activa: " << NombreVigenereActivo() << std::endl;
+  for (const Caso& caso : casos) {
+    std::cout << std::endl << caso.nombre << " (MB/s)" << std::endl;
+    std::cout << std::setw(12) << "Tamaño" << std::setw(12) << "original";
+    for (const ImplementacionVigenere& impl : implementaciones) std::cout << std::setw(12) << impl.nombre;
+    std::cout << std::endl;
+    for (size_t longitud = 1024; longitud <= maximo; longitud *= 16) {
+      const std::string trozo = texto.substr(0, longitud);
+      std::cout << std::setw(12) << longitud << std::fixed << std::setprecision(1);
+      std::cout << std::setw(12) << Medir(longitud, [&] { return caso.original(trozo, clave).size(); });
+      for (const ImplementacionVigenere& impl : implementaciones) {
+        std::cout << std::setw(12) << Medir(longitud, [&] {
+          EstadoVigenere estado;
+          return impl.funcion(trozo.data(), longitud, clave, caso.operacion, salida.data(), caso.tamano_bloque,
+                              estado);
+        });
+      }
+      std::cout << std::endl;
+    }
+  }
+}
+
+/**
+ * @brief Crea en /tmp un fichero de texto del tamaño indicado.
+ *
+ * @param tamano
+ * @return std::string Ruta del fichero
+ */
+std::string CrearTemporal(size_t tamano) {
+  char ruta[] = "/tmp/vigenere_benchmark_XXXXXX";
+  int fd = mkstemp(ruta);
+  if (fd < 0) throw std::runtime_error(std::string("No se puede crear el temporal: ") + std::strerror(errno));
+  const std::string texto = GenerarTexto(std::min(tamano, kTamanoSegmento));
+  for (size_t escritos = 0; escritos < tamano;) {
+    ssize_t n = write(fd, texto.data(), std::min(texto.size(), tamano - escritos));
+    if (n < 0) {
+      int error = errno;
+      close(fd);
+      throw std::runtime_error(std::string("Error de escritura: ") + std::strerror(error));
+    }
+    escritos += static_cast<size_t>(n);
+  }
+  close(fd);
+  return ruta;
+}
+
+/**
+ * @brief Benchmark de escalado del modo paralelo, de 1 a hilos_max hilos.
+ *
+ * Para cada número de hilos se toma la mejor de 3 ejecuciones (tras la
+ * primera, la entrada ya está en la caché de páginas).
+ *
+ * @param tamano Bytes del fichero de entrada
+ * @param hilos_max
+ */
+void BenchmarkParalelo(size_t tamano, unsigned hilos_max) {
+  const std::string entrada = CrearTemporal(tamano);
+  const std::string salida = entrada + ".cifrado";
+  std::cout << "Entrada de " << tamano << " bytes, segmentos de " << kTamanoSegmento << " bytes" << std::endl
+            << std::endl;
+  std::cout << std::setw(8) << "Hilos" << std::setw(12) << "MB/s" << std::setw(14) << "Aceleración" << std::endl;
+  double base = 0;
+  for (unsigned hilos = 1; hilos <= hilos_max; ++hilos) {
+    double mejor = 0;
+    for (int repeticion = 0; repeticion < 3; ++repeticion) {
+      auto inicio = std::chrono::steady_clock::now();
+      ProcesarParalelo(entrada, salida, "CLAVESECRETA", Operacion::kCifrar, 12, hilos);
+      std::chrono::duration<double> segundos = std::chrono::steady_clock::now() - inicio;
+      mejor = std::max(mejor, double(tamano) / segundos.count() / 1e6);
+    }
+    if (hilos == 1) base = mejor;
+    std::cout << std::setw(8) << hilos << std::setw(12) << std::fixed << std::setprecision(1) << mejor
+              << std::setw(11) << std::setprecision(2) << mejor / base << "x" << std::endl;
+  }
+  unlink(entrada.c_str());
+  unlink(salida.c_str());
+}
+
+/**
+ * @brief Benchmarks de Vigenère.
+ *
+ * Uso:
+ *   ./benchmark [nucleos] [tamano_maximo]    MB/s de cada núcleo por tamaño (por defecto hasta 16 MiB)
+ *   ./benchmark paralelo [tamano] [hilos]    escalado de 1 a N hilos (por defecto 1 GiB, todos los núcleos)
+ */
+int main(int argc, char* argv[]) {
+  std::string modo = argc > 1 ? argv[1] : "nucleos";
+  int primero = 2;
+  if (modo != "nucleos" && modo != "paralelo") {
+    modo = "nucleos";
+    primero = 1;
+  }
+  try {
+    if (modo == "paralelo") {
+      size_t tamano = size_t(1) << 30;
+      if (argc > primero) tamano = std::strtoull(argv[primero], nullptr, 10);
+      unsigned hilos = std::thread::hardware_concurrency();
+      if (argc > primero + 1) hilos = static_cast<unsigned>(std::strtoul(argv[primero + 1], nullptr, 10));
+      if (tamano == 0 || hilos == 0) {
+        std::cerr << "El tamaño y el número de hilos deben ser positivos" << std::endl;
+        return 1;
+      }
+      BenchmarkParalelo(tamano, hilos);
+    } else {
+      size_t maximo = size_t(16) << 20;
+      if (argc > primero) maximo = std::strtoull(argv[primero], nullptr, 10);
+      if (maximo < 1024) {
+        std::cerr << "El tamaño máximo debe ser de al menos 1024 bytes" << std::endl;
+        return 1;
+      }
+      BenchmarkNucleos(maximo);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include "../include/clave_continua.h"
+#include "../include/alfabeto.h"
+
+#include <stdexcept>
+
+namespace {
+
+using Tablas = TablasAlfabeto<AlfabetoLatino>;
+
+/**
+ * @brief Recorrido único del texto con la clave tomada del libro.
+ *
+ * Lo que no es letra se salta tanto en el texto como en el libro; si el
+ * libro se agota antes que el texto se lanza std::runtime_error.
+ *
+ * @param posicion Byte del libro por el que va la clave; se actualiza
+ * @return size_t Caracteres escritos
+ */
+template <Operacion kOperacion>
+size_t RecorrerLibro(const char* texto, size_t longitud, const uint8_t* libro, size_t tamano_libro, size_t& posicion,
+                     char* salida, size_t tamano_bloque, EstadoVigenere& estado) {
+  size_t escritos = 0, en_bloque = estado.en_bloque;
+  for (size_t i = 0; i < longitud; ++i) {
+    const unsigned char c = static_cast<unsigned char>(texto[i]);
+    if (!Tablas::kEsLetra[c]) continue;
+    while (posicion < tamano_libro && !Tablas::kEsLetra[libro[posicion]]) ++posicion;
+    if (posicion == tamano_libro) throw std::runtime_error("El libro de la clave se ha agotado");
+    const uint8_t valor_clave = Tablas::kIndice[libro[posicion++]];
+    const uint8_t valor_texto = Tablas::kIndice[c];
+    if (tamano_bloque != 0) {
+      if (en_bloque == tamano_bloque) {
+        salida[escritos++] = ' ';
+        en_bloque = 0;
+      }
+      ++en_bloque;
+    }
+    if (kOperacion == Operacion::kCifrar) {
+      salida[escritos++] = Tablas::kTabula[valor_clave][valor_texto];
+    } else if (kOperacion == Operacion::kDescifrar) {
+      salida[escritos++] = Tablas::kInversa[valor_clave][valor_texto];
+    } else {
+      salida[escritos++] = Tablas::kInversa[valor_texto][valor_clave];
+    }
+  }
+  estado.en_bloque = en_bloque;
+  return escritos;
+}
+
+}  // namespace
+
+/**
+ * @brief Proyecta el libro que hace de clave.
+ *
+ * @param ruta_libro Cualquier texto; solo cuentan sus letras (A-Z, a-z)
+ * @param desplazamiento Byte del libro en el que empieza la clave
+ */
+ClaveContinua::ClaveContinua(const std::string& ruta_libro, size_t desplazamiento)
+    : libro_(ruta_libro), posicion_(desplazamiento), liberado_(desplazamiento) {
+  if (desplazamiento > libro_.Tamano()) {
+    throw std::invalid_argument("El desplazamiento supera el tamaño del libro");
+  }
+  libro_.AccesoSecuencial();
+}
+
+/**
+ * @brief Cifra o descifra un trozo de texto con las siguientes letras del libro.
+ *
+ * Llamadas sucesivas continúan por donde se quedó la anterior, tanto en el
+ * libro como en el bloque de salida (estado.en_bloque; la fase no se usa).
+ *
+ * @param texto
+ * @param longitud
+ * @param operacion
+ * @param salida Buffer de al menos CapacidadSalida(longitud, tamano_bloque) + 1 caracteres
+ * @param tamano_bloque Letras por bloque separadas por espacios (0 = sin bloques)
+ * @param estado
+ * @return size_t Caracteres escritos en salida
+ */
+size_t ClaveContinua::Procesar(const char* texto, size_t longitud, Operacion operacion, char* salida,
+                               size_t tamano_bloque, EstadoVigenere& estado) {
+  const uint8_t* libro = libro_.Datos();
+  const size_t tamano_libro = libro_.Tamano();
+  size_t escritos = 0;
+  switch (operacion) {
+    case Operacion::kCifrar:
+      escritos = RecorrerLibro<Operacion::kCifrar>(texto, longitud, libro, tamano_libro, posicion_, salida,
+                                                   tamano_bloque, estado);
+      break;
+    case Operacion::kDescifrar:
+      escritos = RecorrerLibro<Operacion::kDescifrar>(texto, longitud, libro, tamano_libro, posicion_, salida,
+                                                      tamano_bloque, estado);
+      break;
+    case Operacion::kModificacion:
+      escritos = RecorrerLibro<Operacion::kModificacion>(texto, longitud, libro, tamano_libro, posicion_, salida,
+                                                         tamano_bloque, estado);
+      break;
+  }
+  // Las páginas del libro ya usadas no se vuelven a leer.
+  libro_.Liberar(liberado_, posicion_ - liberado_);
+  liberado_ = posicion_;
+  return escritos;
+}
@@ -0,0 +1,493 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../include/alfabeto.h"
+#include "../include/criptoanalisis.h"
+#include "../include/flujo.h"
+#include "../include/mapeo.h"
+#include "../include/paralelo.h"
+#include "../include/vigenere.h"
+
+/**
+ * @brief Muestra la forma de uso del programa.
+ *
+ * @param programa
+ */
+void MostrarUso(const char* programa) {
+  std::cerr << "Uso:" << std::endl;
+  std::cerr << "  " << programa << "                                                (modo interactivo)" << std::endl;
+  std::cerr << "  " << programa << " --cifrar|--descifrar|--modificacion <clave> [entrada] [salida] [--castellano]"
+            << std::endl;
+  std::cerr << "      --castellano: alfabeto de 27 letras con la Ñ; el texto va en Latin-1 (iconv -f UTF-8 -t LATIN1)"
+            << std::endl;
+  std::cerr << "  " << programa << " --paralelo <cifrar|descifrar|modificacion> <hilos> <clave> <entrada> <salida>"
+            << " [--castellano]  (0 hilos = todos los núcleos)" << std::endl;
+  std::cerr << "  " << programa << " --clave-continua <cifrar|descifrar|modificacion> <libro> <desplazamiento>"
+            << " [entrada] [salida]" << std::endl;
+  std::cerr << "  " << programa << " --analizar <fichero> [longitud_maxima] [hilos]" << std::endl;
+  std::cerr << "  " << programa << " --analizar-lote <fichero> [longitud_maxima] [hilos]  (un cifrado por línea)"
+            << std::endl;
+  std::cerr << "  " << programa << " --recuperar <fichero> <longitud> [mejores] [--ingles]  (longitud 0 = estimarla)"
+            << std::endl;
+  std::cerr << "  " << programa << " --recuperar-lote <fichero> <longitud> [mejores] [hilos] [--ingles]" << std::endl;
+  std::cerr << "      --ingles: puntúa las claves con las frecuencias del inglés en lugar de las del castellano"
+            << std::endl;
+}
+
+/**
+ * @brief Abre un fichero del modo flujo; "-" o ausente indica la entrada/salida estándar.
+ *
+ * La salida se trunca solo después de comprobar que no es el fichero de
+ * entrada ni uno proyectado (el libro de la clave continua): si lo fuera, se
+ * vaciaría antes de leerlo, y truncar una proyección termina con SIGBUS.
+ *
+ * @param ruta
+ * @param escritura
+ * @param entrada Descriptor de entrada ya abierto (al abrir la salida), o -1
+ * @param mapeados Ficheros proyectados que la salida no puede sobrescribir
+ * @return int Descriptor
+ */
+int AbrirDescriptor(const char* ruta, bool escritura, int entrada = -1,
+                    std::initializer_list<const ArchivoMapeado*> mapeados = {}) {
+  if (ruta == nullptr || std::string(ruta) == "-") return escritura ? STDOUT_FILENO : STDIN_FILENO;
+  int fd = escritura ? open(ruta, O_WRONLY | O_CREAT, 0644) : open(ruta, O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("No se puede abrir ") + ruta + ": " + std::strerror(errno));
+  }
+  if (escritura) {
+    if (entrada >= 0 && MismoArchivo(entrada, fd)) {
+      close(fd);
+      throw std::invalid_argument("La entrada y la salida son el mismo fichero");
+    }
+    for (const ArchivoMapeado* mapeado : mapeados) {
+      if (mapeado->MismoArchivo(fd)) {
+        close(fd);
+        throw std::invalid_argument("La salida no puede ser el libro de la clave");
+      }
+    }
+    if (ftruncate(fd, 0) < 0) {
+      int error = errno;
+      close(fd);
+      throw std::runtime_error(std::string("No se puede truncar ") + ruta + ": " + std::strerror(error));
+    }
+  }
+  return fd;
+}
+
+/**
+ * @brief Cierra los descriptores del modo flujo que no sean los estándar.
+ *
+ * @param entrada
+ * @param salida
+ */
+void CerrarDescriptores(int entrada, int salida) {
+  if (entrada != STDIN_FILENO) close(entrada);
+  if (salida != STDOUT_FILENO && close(salida) < 0) {
+    throw std::runtime_error(std::string("Error al cerrar la salida: ") + std::strerror(errno));
+  }
+}
+
+/**
+ * @brief Convierte a Latin-1 los caracteres de dos bytes de UTF-8 que caben en él (como la Ñ).
+ *
+ * @param texto
+ * @return std::string
+ */
+std::string Utf8ALatin1(const std::string& texto) {
+  std::string latin1;
+  for (size_t i = 0; i < texto.size(); ++i) {
+    const unsigned char c = static_cast<unsigned char>(texto[i]);
+    if ((c == 0xC2 || c == 0xC3) && i + 1 < texto.size()) {
+      latin1 += static_cast<char>(((c & 0x03) << 6) | (static_cast<unsigned char>(texto[++i]) & 0x3F));
+    } else {
+      latin1 += static_cast<char>(c);
+    }
+  }
+  return latin1;
+}
+
+/**
+ * @brief Modo flujo: procesa ficheros o tuberías de cualquier tamaño con memoria acotada.
+ *
+ * Cifrar y descifrar agrupan en bloques del tamaño de la clave y la
+ * modificación no, igual que las funciones que trabajan sobre un std::string.
+ *
+ * @param argc
+ * @param argv
+ * @param operacion
+ * @return int
+ */
+int ModoFlujo(int argc, char* argv[], Operacion operacion) {
+  const bool castellano = argc > 3 && std::string(argv[argc - 1]) == "--castellano";
+  if (castellano) --argc;
+  if (argc < 3 || argc > 5) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  // La clave llega en UTF-8 desde la línea de órdenes; el alfabeto castellano trabaja en Latin-1.
+  const std::string clave = castellano ? Utf8ALatin1(argv[2]) : argv[2];
+  const size_t tamano_bloque = operacion == Operacion::kModificacion ? 0 : clave.size();
+  int entrada = AbrirDescriptor(argc > 3 ? argv[3] : nullptr, false);
+  int salida = AbrirDescriptor(argc > 4 ? argv[4] : nullptr, true, entrada);
+  FuncionVigenere nucleo = ProcesarVigenere;
+  if (castellano) nucleo = ProcesarVigenereAlfabeto<AlfabetoCastellano>;
+  ProcesarFlujo(entrada, salida, clave, operacion, tamano_bloque, nucleo);
+  CerrarDescriptores(entrada, salida);
+  return 0;
+}
+
+/**
+ * @brief Traduce el nombre de una operación (cifrar, descifrar o modificacion).
+ *
+ * @param nombre
+ * @param operacion
+ * @return true si el nombre es válido
+ */
+bool LeerOperacion(const std::string& nombre, Operacion& operacion) {
+  if (nombre == "cifrar") {
+    operacion = Operacion::kCifrar;
+  } else if (nombre == "descifrar") {
+    operacion = Operacion::kDescifrar;
+  } else if (nombre == "modificacion") {
+    operacion = Operacion::kModificacion;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Modo paralelo: reparte un fichero grande en segmentos entre varios hilos.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoParalelo(int argc, char* argv[]) {
+  const bool castellano = argc > 2 && std::string(argv[argc - 1]) == "--castellano";
+  if (castellano) --argc;
+  if (argc != 7) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  Operacion operacion;
+  if (!LeerOperacion(argv[2], operacion)) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  const unsigned hilos = static_cast<unsigned>(std::stoul(argv[3]));
+  const std::string clave = castellano ? Utf8ALatin1(argv[4]) : argv[4];
+  const size_t tamano_bloque = operacion == Operacion::kModificacion ? 0 : clave.size();
+  size_t total;
+  if (castellano) {
+    total = ProcesarParalelo(argv[5], argv[6], clave, operacion, tamano_bloque, hilos,
+                             ProcesarVigenereAlfabeto<AlfabetoCastellano>, ContarLetras<AlfabetoCastellano>);
+  } else {
+    total = ProcesarParalelo(argv[5], argv[6], clave, operacion, tamano_bloque, hilos);
+  }
+  std::cerr << "Escritos " << total << " caracteres" << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Modo clave continua: la clave son las letras de un libro a partir de un desplazamiento.
+ *
+ * Al terminar muestra por la salida de error hasta qué byte del libro se ha
+ * usado, que es el desplazamiento para el siguiente mensaje.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoClaveContinua(int argc, char* argv[]) {
+  Operacion operacion;
+  if (argc < 5 || argc > 7 || !LeerOperacion(argv[2], operacion)) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  ClaveContinua clave(argv[3], std::stoull(argv[4]));
+  const size_t tamano_bloque = operacion == Operacion::kModificacion ? 0 : kBloqueClaveContinua;
+  int entrada = AbrirDescriptor(argc > 5 ? argv[5] : nullptr, false);
+  int salida = AbrirDescriptor(argc > 6 ? argv[6] : nullptr, true, entrada, {&clave.Libro()});
+  ProcesarFlujo(entrada, salida, clave, operacion, tamano_bloque);
+  CerrarDescriptores(entrada, salida);
+  std::cerr << "Siguiente desplazamiento en el libro: " << clave.Posicion() << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Abre un fichero para lectura o lanza std::runtime_error.
+ *
+ * @param ruta
+ * @return std::ifstream
+ */
+std::ifstream AbrirFichero(const std::string& ruta) {
+  std::ifstream fichero(ruta, std::ios::binary);
+  if (!fichero) throw std::runtime_error("No se puede abrir " + ruta + ": " + std::strerror(errno));
+  return fichero;
+}
+
+/**
+ * @brief Lee un fichero con un texto cifrado por línea.
+ *
+ * @param ruta
+ * @return std::vector<std::string>
+ */
+std::vector<std::string> LeerLineas(const std::string& ruta) {
+  std::ifstream fichero = AbrirFichero(ruta);
+  std::vector<std::string> lineas;
+  for (std::string linea; std::getline(fichero, linea);) lineas.push_back(std::move(linea));
+  return lineas;
+}
+
+/**
+ * @brief Lee los argumentos opcionales [longitud_maxima] [hilos] de los modos de análisis.
+ */
+void LeerOpcionesAnalisis(int argc, char* argv[], size_t& longitud_maxima, unsigned& hilos) {
+  longitud_maxima = argc > 3 ? std::stoull(argv[3]) : kLongitudMaximaClave;
+  hilos = argc > 4 ? static_cast<unsigned>(std::stoul(argv[4])) : 0;
+}
+
+/**
+ * @brief Estima la longitud de la clave de un fichero cifrado (Friedman y Kasiski).
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoAnalizar(int argc, char* argv[]) {
+  if (argc < 3 || argc > 5) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  size_t longitud_maxima;
+  unsigned hilos;
+  LeerOpcionesAnalisis(argc, argv, longitud_maxima, hilos);
+  std::ifstream fichero = AbrirFichero(argv[2]);
+  std::ostringstream contenido;
+  contenido << fichero.rdbuf();
+  AnalisisLongitud analisis = AnalizarLongitud(contenido.str(), longitud_maxima, hilos);
+
+  std::cout << "Letras: " << analisis.letras << std::endl;
+  std::cout << std::setw(9) << "Longitud" << std::setw(12) << "IC" << std::setw(12) << "Kasiski" << std::endl;
+  for (size_t l = 1; l <= longitud_maxima; ++l) {
+    std::cout << std::setw(9) << l << std::setw(12) << std::fixed << std::setprecision(4)
+              << analisis.indice_coincidencia[l] << std::setw(12) << analisis.kasiski[l]
+              << (l == analisis.longitud_estimada ? "  <-" : "") << std::endl;
+  }
+  std::cout << "Estimación de Friedman: " << std::setprecision(2) << analisis.estimacion_friedman << std::endl;
+  std::cout << "Longitud estimada: " << analisis.longitud_estimada << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Estima la longitud de la clave de cada línea de un fichero.
+ *
+ * Por la salida estándar escribe una línea por cifrado con su longitud
+ * estimada; por la salida de error, el resumen del lote y el rendimiento.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoAnalizarLote(int argc, char* argv[]) {
+  if (argc < 3 || argc > 5) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  size_t longitud_maxima;
+  unsigned hilos;
+  LeerOpcionesAnalisis(argc, argv, longitud_maxima, hilos);
+  std::vector<std::string> cifrados = LeerLineas(argv[2]);
+
+  ResumenLote resumen;
+  auto inicio = std::chrono::steady_clock::now();
+  std::vector<AnalisisLongitud> resultados = AnalizarLote(cifrados, longitud_maxima, hilos, &resumen);
+  std::chrono::duration<double> segundos = std::chrono::steady_clock::now() - inicio;
+
+  std::ostringstream salida;
+  for (size_t i = 0; i < resultados.size(); ++i) salida << i + 1 << ' ' << resultados[i].longitud_estimada << '\n';
+  std::cout << salida.str();
+
+  std::cerr << "Cifrados: " << cifrados.size() << ", letras: " << resumen.letras << std::endl;
+  std::cerr << "Tiempo: " << std::fixed << std::setprecision(3) << segundos.count() << " s ("
+            << std::setprecision(0) << static_cast<double>(cifrados.size()) / segundos.count() << " cifrados/s)"
+            << std::endl;
+  std::cerr << "Longitudes estimadas:";
+  for (size_t l = 1; l <= longitud_maxima; ++l) {
+    if (resumen.por_longitud[l] != 0) std::cerr << ' ' << l << ':' << resumen.por_longitud[l];
+  }
+  std::cerr << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Muestra las claves más probables de un fichero cifrado y el descifrado con la mejor.
+ *
+ * Con --ingles al final, las claves se puntúan con las frecuencias del inglés.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoRecuperar(int argc, char* argv[]) {
+  const bool ingles = argc > 4 && std::string(argv[argc - 1]) == "--ingles";
+  if (ingles) --argc;
+  if (argc < 4 || argc > 5) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  const size_t longitud_clave = std::stoull(argv[3]);
+  const size_t mejores = argc > 4 ? std::stoull(argv[4]) : 5;
+  std::ifstream fichero = AbrirFichero(argv[2]);
+  std::ostringstream contenido;
+  contenido << fichero.rdbuf();
+  const std::string cifrado = contenido.str();
+  std::vector<ClaveCandidata> claves =
+      RecuperarClave(cifrado, longitud_clave, mejores, ingles ? Idioma::kIngles : Idioma::kCastellano);
+  if (claves.empty()) {
+    std::cerr << "El fichero no contiene letras" << std::endl;
+    return 1;
+  }
+  std::cout << std::setw(4) << "#" << "  " << std::setw(12) << std::left << "Chi-cuadrado" << "  Clave" << std::right
+            << std::endl;
+  for (size_t i = 0; i < claves.size(); ++i) {
+    std::cout << std::setw(4) << i + 1 << "  " << std::setw(12) << std::left << std::fixed << std::setprecision(1)
+              << claves[i].puntuacion << std::right << "  " << claves[i].clave << std::endl;
+  }
+  std::string descifrado = DescifrarVigenere(cifrado, claves[0].clave);
+  if (descifrado.size() > 80) descifrado = descifrado.substr(0, 80) + "...";
+  std::cout << "Descifrado: " << descifrado << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Recupera la clave de cada línea de un fichero.
+ *
+ * Por la salida estándar escribe, por cada cifrado, sus claves separadas por
+ * espacios con su puntuación; por la salida de error, el rendimiento. Con
+ * --ingles al final, las claves se puntúan con las frecuencias del inglés.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int ModoRecuperarLote(int argc, char* argv[]) {
+  const bool ingles = argc > 4 && std::string(argv[argc - 1]) == "--ingles";
+  if (ingles) --argc;
+  if (argc < 4 || argc > 6) {
+    MostrarUso(argv[0]);
+    return 1;
+  }
+  const size_t longitud_clave = std::stoull(argv[3]);
+  const size_t mejores = argc > 4 ? std::stoull(argv[4]) : 1;
+  const unsigned hilos = argc > 5 ? static_cast<unsigned>(std::stoul(argv[5])) : 0;
+  std::vector<std::string> cifrados = LeerLineas(argv[2]);
+
+  auto inicio = std::chrono::steady_clock::now();
+  std::vector<std::vector<ClaveCandidata>> resultados = RecuperarLote(
+      cifrados, longitud_clave, mejores, ingles ? Idioma::kIngles : Idioma::kCastellano, hilos);
+  std::chrono::duration<double> segundos = std::chrono::steady_clock::now() - inicio;
+
+  std::ostringstream salida;
+  salida << std::fixed << std::setprecision(1);
+  size_t claves = 0;
+  for (size_t i = 0; i < resultados.size(); ++i) {
+    salida << i + 1;
+    for (const ClaveCandidata& candidata : resultados[i]) {
+      salida << ' ' << candidata.clave << ':' << candidata.puntuacion;
+    }
+    salida << '\n';
+    claves += resultados[i].size();
+  }
+  std::cout << salida.str();
+
+  std::cerr << "Cifrados: " << cifrados.size() << ", claves: " << claves << std::endl;
+  std::cerr << "Tiempo: " << std::fixed << std::setprecision(3) << segundos.count() << " s ("
+            << std::setprecision(0) << static_cast<double>(cifrados.size()) / segundos.count() << " cifrados/s, "
+            << static_cast<double>(claves) / segundos.count() << " claves/s)" << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Modo interactivo: menú original de cifrado y descifrado.
+ *
+ * @return int
+ */
+int ModoInteractivo() {
+  std::string texto, clave;
+  int opcion;
+  std::cout << "Introduce el texto: ";
+  getline(std::cin, texto);
+  std::cout << "Introduce la clave: ";
+  std::cin >> clave;
+  std::cout << "Introduce la opcion: \n";
+  std::cout << "1. Cifrado Vigenere\n";
+  std::cout << "2. Descifrado Vigenere\n";
+  std::cout << "3. Cifrado Modificacion\n";
+  std::cout << "4. Salir Programa\n";
+  std::cin >> opcion;
+  try {
+    switch (opcion)
+    {
+    case 1:
+      std::cout << "Texto Cifrado: " << CifrarVigenere(texto, clave) << std::endl;
+      break;
+    case 2:
+      std::cout << "Texto Descifrado: " << DescifrarVigenere(texto, clave) << std::endl;
+      break;
+    case 3:
+      std::cout << "Cifrado Modificación: " << CifradoModificacion(texto, clave) << std::endl;
+      break;
+    case 4:
+      std::cout << "Saliendo del programa..." << std::endl;
+      break;
+    default:
+      std::cout << "Opcion no valida" << std::endl;
+      break;
+    }
+  } catch (const std::invalid_argument& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  // std::cout << "Texto Cifrado: " << CifrarVigenere(texto, clave) << std::endl;
+  // std::cout << "Texto Descifrado: " << DescifrarVigenere(CifrarVigenere(texto, clave), clave) << std::endl;
+  // std::cout << "Cifrado Modificación: " << CifradoModificacion(clave, texto) << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Función principal
+ *
+ * @return int
+ */
+int main(int argc, char* argv[]) {
+  if (argc == 1) return ModoInteractivo();
+  try {
+    std::string modo = argv[1];
+    if (modo == "--cifrar") return ModoFlujo(argc, argv, Operacion::kCifrar);
+    if (modo == "--descifrar") return ModoFlujo(argc, argv, Operacion::kDescifrar);
+    if (modo == "--modificacion") return ModoFlujo(argc, argv, Operacion::kModificacion);
+    if (modo == "--paralelo") return ModoParalelo(argc, argv);
+    if (modo == "--clave-continua") return ModoClaveContinua(argc, argv);
+    if (modo == "--analizar") return ModoAnalizar(argc, argv);
+    if (modo == "--analizar-lote") return ModoAnalizarLote(argc, argv);
+    if (modo == "--recuperar") return ModoRecuperar(argc, argv);
+    if (modo == "--recuperar-lote") return ModoRecuperarLote(argc, argv);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  MostrarUso(argv[0]);
+  return 1;
+}
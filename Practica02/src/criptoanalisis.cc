@@ -0,0 +1,509 @@
+#include "../include/criptoanalisis.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// Índice de coincidencia de un texto aleatorio (1/26) y del castellano.
+const double kIndiceAleatorio = 1.0 / 26.0;
+const double kIndiceCastellano = 0.0775;
+// Fracción de la subida máxima del índice (sobre el del texto entero) que debe
+// alcanzar una longitud; así no se eligen los múltiplos de la longitud real.
+const double kUmbralSubida = 0.5;
+const size_t kSinPosicion = static_cast<size_t>(-1);
+
+// Frecuencia de cada letra (en %) en textos en castellano (sin la Ñ) y en inglés.
+const double kFrecuenciasCastellano[26] = {12.53, 1.42, 4.68, 5.86, 13.68, 0.69, 1.01, 0.70, 6.25,
+                                           0.44,  0.02, 4.97, 3.15, 6.71,  8.68, 2.51, 0.88, 6.87,
+                                           7.98,  4.63, 3.93, 0.90, 0.01,  0.22, 0.90, 0.52};
+const double kFrecuenciasIngles[26] = {8.167, 1.492, 2.782, 4.253, 12.702, 2.228, 2.015, 6.094, 6.966,
+                                       0.153, 0.772, 4.025, 2.406, 6.749,  7.507, 1.929, 0.095, 5.987,
+                                       6.327, 9.056, 2.758, 0.978, 2.360,  0.150, 1.974, 0.074};
+
+/**
+ * @brief Deja en letras los valores (0..25) de las letras del texto.
+ *
+ * Mismo criterio que el cifrado: solo cuentan las letras ASCII.
+ *
+ * @param texto
+ * @param letras Se sobrescribe (se reutiliza entre textos para no reservar memoria)
+ */
+void ExtraerLetras(const std::string& texto, std::vector<uint8_t>& letras) {
+  letras.clear();
+  letras.reserve(texto.size());
+  for (char c : texto) {
+    const uint8_t valor = static_cast<uint8_t>((static_cast<unsigned char>(c) & 0xDF) - 'A');
+    if (valor < 26) letras.push_back(valor);
+  }
+}
+
+/**
+ * @brief Resuelve el número de hilos: 0 significa todos los núcleos.
+ */
+unsigned ResolverHilos(unsigned hilos) {
+  if (hilos == 0) hilos = std::thread::hardware_concurrency();
+  return hilos == 0 ? 1 : hilos;
+}
+
+/**
+ * @brief Histogramas por columna y tabla de trigramas de un tramo del texto.
+ *
+ * Cada hilo rellena el suyo sin compartir nada; al final se suman en orden.
+ * Para cada longitud L hay L histogramas de 26 letras (la letra de la
+ * posición p va a la columna p mod L). La tabla de trigramas guarda la
+ * primera y la última aparición de cada trigrama en el tramo: al unir dos
+ * tramos consecutivos, la distancia entre la última del primero y la primera
+ * del segundo es la única que faltaba por contar.
+ */
+class Acumulador {
+ public:
+  explicit Acumulador(size_t longitud_maxima)
+      : longitud_maxima_(longitud_maxima),
+        columnas_(Base(longitud_maxima + 1)),
+        kasiski_(longitud_maxima + 1),
+        primera_(kTrigramas, kSinPosicion),
+        ultima_(kTrigramas, kSinPosicion),
+        fase_(longitud_maxima + 1) {
+    // Reservado de antemano para que Procesar no pueda lanzar dentro de un hilo.
+    tocados_.reserve(kTrigramas);
+  }
+
+  /**
+   * @brief Deja el acumulador vacío; solo se limpian los trigramas usados.
+   */
+  void Reiniciar() {
+    std::fill(columnas_.begin(), columnas_.end(), 0);
+    std::fill(kasiski_.begin(), kasiski_.end(), 0);
+    for (uint16_t trigrama : tocados_) primera_[trigrama] = ultima_[trigrama] = kSinPosicion;
+    tocados_.clear();
+  }
+
+  /**
+   * @brief Cuenta las letras [inicio, fin) de un texto de n letras.
+   *
+   * Los trigramas que empiezan al final del tramo leen letras del siguiente,
+   * que pertenecen al mismo texto.
+   */
+  void Procesar(const uint8_t* letras, size_t n, size_t inicio, size_t fin) {
+    for (size_t l = 1; l <= longitud_maxima_; ++l) fase_[l] = inicio % l;
+    for (size_t p = inicio; p < fin; ++p) {
+      const uint8_t letra = letras[p];
+      // Una fase por longitud en lugar de p % L en cada letra.
+      for (size_t l = 1; l <= longitud_maxima_; ++l) {
+        ++columnas_[Base(l) + fase_[l] * 26 + letra];
+        if (++fase_[l] == l) fase_[l] = 0;
+      }
+      if (p + 2 >= n) continue;
+      const uint16_t trigrama = static_cast<uint16_t>(letra * 676 + letras[p + 1] * 26 + letras[p + 2]);
+      if (ultima_[trigrama] == kSinPosicion) {
+        primera_[trigrama] = p;
+        tocados_.push_back(trigrama);
+      } else {
+        ContarDistancia(p - ultima_[trigrama]);
+      }
+      ultima_[trigrama] = p;
+    }
+  }
+
+  /**
+   * @brief Añade el acumulador del tramo que va justo a continuación de este.
+   */
+  void Sumar(const Acumulador& siguiente) {
+    for (size_t i = 0; i < columnas_.size(); ++i) columnas_[i] += siguiente.columnas_[i];
+    for (size_t l = 0; l < kasiski_.size(); ++l) kasiski_[l] += siguiente.kasiski_[l];
+    for (uint16_t trigrama : siguiente.tocados_) {
+      if (ultima_[trigrama] == kSinPosicion) {
+        primera_[trigrama] = siguiente.primera_[trigrama];
+        tocados_.push_back(trigrama);
+      } else {
+        ContarDistancia(siguiente.primera_[trigrama] - ultima_[trigrama]);
+      }
+      ultima_[trigrama] = siguiente.ultima_[trigrama];
+    }
+  }
+
+  /**
+   * @brief Calcula los índices de coincidencia y estima la longitud de la clave.
+   *
+   * @param letras Letras del texto completo
+   * @return AnalisisLongitud
+   */
+  AnalisisLongitud Resultado(size_t letras) const {
+    AnalisisLongitud analisis;
+    analisis.letras = letras;
+    analisis.kasiski = kasiski_;
+    analisis.indice_coincidencia.assign(longitud_maxima_ + 1, 0.0);
+    for (size_t l = 1; l <= longitud_maxima_; ++l) {
+      double suma = 0.0;
+      size_t columnas_validas = 0;
+      for (size_t columna = 0; columna < l; ++columna) {
+        const uint64_t* histograma = Histograma(l, columna);
+        uint64_t total = 0, parejas = 0;
+        for (size_t letra = 0; letra < 26; ++letra) {
+          total += histograma[letra];
+          parejas += histograma[letra] * (histograma[letra] - 1);  // Con 0 da 0 igualmente
+        }
+        if (total < 2) continue;
+        suma += static_cast<double>(parejas) / (static_cast<double>(total) * static_cast<double>(total - 1));
+        ++columnas_validas;
+      }
+      if (columnas_validas != 0) analisis.indice_coincidencia[l] = suma / static_cast<double>(columnas_validas);
+    }
+
+    const double indice_texto = analisis.indice_coincidencia[1];
+    if (indice_texto > kIndiceAleatorio) {
+      analisis.estimacion_friedman = (kIndiceCastellano - kIndiceAleatorio) / (indice_texto - kIndiceAleatorio);
+    }
+    const double maximo = *std::max_element(analisis.indice_coincidencia.begin() + 1,
+                                            analisis.indice_coincidencia.end());
+    if (maximo > 0.0) {
+      const double umbral = indice_texto + kUmbralSubida * (maximo - indice_texto);
+      size_t l = 1;
+      while (analisis.indice_coincidencia[l] < umbral) ++l;
+      analisis.longitud_estimada = l;
+    }
+    return analisis;
+  }
+
+  // Histograma de todo el tramo (la única columna de longitud 1).
+  const uint64_t* Frecuencias() const { return columnas_.data(); }
+
+  // Histograma de una columna para la longitud l (1..longitud_maxima).
+  const uint64_t* Histograma(size_t l, size_t columna) const { return &columnas_[Base(l) + columna * 26]; }
+
+ private:
+  // Posición del primer histograma de la longitud l: hay 1 + 2 + ... + (l - 1) antes.
+  static size_t Base(size_t l) { return 26 * (l * (l - 1) / 2); }
+
+  void ContarDistancia(size_t distancia) {
+    for (size_t l = 1; l <= longitud_maxima_; ++l) {
+      if (distancia % l == 0) ++kasiski_[l];
+    }
+  }
+
+  size_t longitud_maxima_;
+  std::vector<uint64_t> columnas_;
+  std::vector<uint64_t> kasiski_;
+  std::vector<size_t> primera_;
+  std::vector<size_t> ultima_;
+  std::vector<uint16_t> tocados_;
+  std::vector<size_t> fase_;
+};
+
+void ComprobarLongitudMaxima(size_t longitud_maxima) {
+  if (longitud_maxima == 0) throw std::invalid_argument("La longitud máxima de clave debe ser al menos 1");
+}
+
+/**
+ * @brief Frecuencias esperadas del idioma, normalizadas para que sumen 1.
+ *
+ * @param idioma
+ * @return std::array<double, 26>
+ */
+std::array<double, 26> FrecuenciasIdioma(Idioma idioma) {
+  const double* tabla = idioma == Idioma::kIngles ? kFrecuenciasIngles : kFrecuenciasCastellano;
+  double total = 0.0;
+  for (size_t letra = 0; letra < 26; ++letra) total += tabla[letra];
+  std::array<double, 26> frecuencias;
+  for (size_t letra = 0; letra < 26; ++letra) frecuencias[letra] = tabla[letra] / total;
+  return frecuencias;
+}
+
+/**
+ * @brief Chi-cuadrado de una columna para cada uno de los 26 desplazamientos.
+ *
+ * Si la letra de clave de la columna es k, la letra en claro i aparece
+ * cifrada como (i + k) mod 26; basta con comparar el histograma rotado con
+ * el esperado, sin descifrar nada.
+ *
+ * @param histograma 26 contadores de la columna
+ * @param frecuencias Del idioma, normalizadas
+ * @return std::array<double, 26> Puntuación de cada letra de clave
+ */
+std::array<double, 26> PuntuarColumna(const uint64_t* histograma, const std::array<double, 26>& frecuencias) {
+  uint64_t total = 0;
+  for (size_t letra = 0; letra < 26; ++letra) total += histograma[letra];
+  std::array<double, 26> puntuaciones = {};
+  if (total == 0) return puntuaciones;
+  for (size_t k = 0; k < 26; ++k) {
+    double chi = 0.0;
+    for (size_t letra = 0, cifrada = k; letra < 26; ++letra, cifrada = cifrada == 25 ? 0 : cifrada + 1) {
+      const double esperado = frecuencias[letra] * static_cast<double>(total);
+      const double diferencia = static_cast<double>(histograma[cifrada]) - esperado;
+      chi += diferencia * diferencia / esperado;
+    }
+    puntuaciones[k] = chi;
+  }
+  return puntuaciones;
+}
+
+/**
+ * @brief Las mejores claves combinando una letra por columna.
+ *
+ * Las columnas son independientes, así que la puntuación de una clave es la
+ * suma de las de sus letras. Se añade columna a columna conservando solo las
+ * mejores claves parciales; de cada columna basta con sus mejores letras,
+ * ya que otra peor nunca puede entrar en las primeras.
+ *
+ * @param puntuaciones Una entrada por columna
+ * @param mejores
+ * @return std::vector<ClaveCandidata> De mejor a peor
+ */
+std::vector<ClaveCandidata> MejoresClaves(const std::vector<std::array<double, 26>>& puntuaciones, size_t mejores) {
+  const size_t letras_por_columna = std::min<size_t>(mejores, 26);
+  auto mejor = [](const ClaveCandidata& a, const ClaveCandidata& b) { return a.puntuacion < b.puntuacion; };
+  std::vector<ClaveCandidata> claves = {{"", 0.0}}, siguientes;
+  std::array<uint8_t, 26> orden;
+  for (const std::array<double, 26>& columna : puntuaciones) {
+    for (size_t k = 0; k < 26; ++k) orden[k] = static_cast<uint8_t>(k);
+    std::partial_sort(orden.begin(), orden.begin() + letras_por_columna, orden.end(),
+                      [&](uint8_t a, uint8_t b) { return columna[a] < columna[b]; });
+    siguientes.clear();
+    for (const ClaveCandidata& parcial : claves) {
+      for (size_t i = 0; i < letras_por_columna; ++i) {
+        siguientes.push_back(
+            {parcial.clave + static_cast<char>('A' + orden[i]), parcial.puntuacion + columna[orden[i]]});
+      }
+    }
+    const size_t conservar = std::min(mejores, siguientes.size());
+    std::partial_sort(siguientes.begin(), siguientes.begin() + conservar, siguientes.end(), mejor);
+    siguientes.resize(conservar);
+    claves.swap(siguientes);
+  }
+  return claves;
+}
+
+/**
+ * @brief Recupera las mejores claves de un texto ya reducido a letras.
+ *
+ * Con longitud_clave 0 la longitud se estima primero con el acumulador y se
+ * aprovechan sus histogramas; si no, se cuentan solo las columnas necesarias.
+ *
+ * @param histogramas Buffer reutilizable para las columnas
+ */
+std::vector<ClaveCandidata> RecuperarDeLetras(const std::vector<uint8_t>& letras, size_t longitud_clave,
+                                              size_t mejores, const std::array<double, 26>& frecuencias,
+                                              Acumulador& acumulador, std::vector<uint64_t>& histogramas) {
+  std::vector<std::array<double, 26>> puntuaciones;
+  if (longitud_clave == 0) {
+    acumulador.Reiniciar();
+    acumulador.Procesar(letras.data(), letras.size(), 0, letras.size());
+    longitud_clave = acumulador.Resultado(letras.size()).longitud_estimada;
+    for (size_t columna = 0; columna < longitud_clave; ++columna) {
+      puntuaciones.push_back(PuntuarColumna(acumulador.Histograma(longitud_clave, columna), frecuencias));
+    }
+  } else {
+    histogramas.assign(longitud_clave * 26, 0);
+    size_t columna = 0;
+    for (uint8_t letra : letras) {
+      ++histogramas[columna * 26 + letra];
+      if (++columna == longitud_clave) columna = 0;
+    }
+    for (size_t columna = 0; columna < longitud_clave; ++columna) {
+      puntuaciones.push_back(PuntuarColumna(&histogramas[columna * 26], frecuencias));
+    }
+  }
+  if (longitud_clave == 0) return {};
+  return MejoresClaves(puntuaciones, mejores);
+}
+
+void ComprobarMejores(size_t mejores) {
+  if (mejores == 0) throw std::invalid_argument("Hay que pedir al menos una clave");
+}
+
+}  // namespace
+
+/**
+ * @brief Estima la longitud de la clave de un texto cifrado con Vigenère.
+ *
+ * Para cada longitud candidata L (1..longitud_maxima) calcula el índice de
+ * coincidencia medio de las L columnas (Friedman) y cuántas distancias entre
+ * trigramas repetidos son múltiplo de L (Kasiski). Con la longitud correcta
+ * cada columna es un César y su índice sube al del idioma; se elige la menor
+ * longitud que alcanza la mitad de la subida máxima, ya que sus múltiplos
+ * también la alcanzan.
+ *
+ * Los textos grandes se reparten en tramos entre varios hilos; cada hilo
+ * llena sus propios histogramas y al final se suman.
+ *
+ * @param cifrado Solo se tienen en cuenta las letras
+ * @param longitud_maxima
+ * @param hilos 0 para usar todos los núcleos disponibles
+ * @return AnalisisLongitud
+ */
+AnalisisLongitud AnalizarLongitud(const std::string& cifrado, size_t longitud_maxima, unsigned hilos) {
+  ComprobarLongitudMaxima(longitud_maxima);
+  std::vector<uint8_t> letras;
+  ExtraerLetras(cifrado, letras);
+  const size_t n = letras.size();
+  hilos = std::min<size_t>(ResolverHilos(hilos), std::max<size_t>(1, n / kLetrasMinimasPorHilo));
+
+  std::vector<Acumulador> parciales;
+  parciales.reserve(hilos);
+  for (unsigned i = 0; i < hilos; ++i) parciales.emplace_back(longitud_maxima);
+  std::vector<std::thread> trabajadores;
+  std::exception_ptr error;
+  try {
+    for (unsigned i = 1; i < hilos; ++i) {
+      trabajadores.emplace_back(
+          [&, i]() { parciales[i].Procesar(letras.data(), n, n * i / hilos, n * (i + 1) / hilos); });
+    }
+  } catch (...) {
+    // No se pudo crear un hilo: faltarían tramos, así que solo se unen los ya creados.
+    error = std::current_exception();
+  }
+  if (!error) parciales[0].Procesar(letras.data(), n, 0, n / hilos);
+  for (std::thread& hilo : trabajadores) hilo.join();
+  if (error) std::rethrow_exception(error);
+  for (unsigned i = 1; i < hilos; ++i) parciales[0].Sumar(parciales[i]);
+  return parciales[0].Resultado(n);
+}
+
+/**
+ * @brief Analiza muchos textos cifrados a la vez.
+ *
+ * Los hilos toman textos de un contador compartido; cada uno reutiliza su
+ * acumulador y lleva sus propios totales (frecuencias de letras y
+ * longitudes estimadas), que se suman una sola vez al terminar.
+ *
+ * @param cifrados
+ * @param longitud_maxima
+ * @param hilos 0 para usar todos los núcleos disponibles
+ * @param resumen Si no es nulo, recibe los totales del lote
+ * @return std::vector<AnalisisLongitud> Un resultado por texto, en el mismo orden
+ */
+std::vector<AnalisisLongitud> AnalizarLote(const std::vector<std::string>& cifrados, size_t longitud_maxima,
+                                           unsigned hilos, ResumenLote* resumen) {
+  ComprobarLongitudMaxima(longitud_maxima);
+  std::vector<AnalisisLongitud> resultados(cifrados.size());
+  hilos = std::min<size_t>(ResolverHilos(hilos), std::max<size_t>(1, cifrados.size()));
+  std::vector<ResumenLote> parciales(hilos);
+  std::atomic<size_t> siguiente(0);
+  std::atomic<bool> fallo(false);
+  std::exception_ptr error;
+
+  auto trabajador = [&](unsigned hilo) {
+    try {
+      Acumulador acumulador(longitud_maxima);
+      std::vector<uint8_t> letras;
+      ResumenLote& parcial = parciales[hilo];
+      parcial.por_longitud.assign(longitud_maxima + 1, 0);
+      size_t i;
+      while (!fallo.load(std::memory_order_relaxed) &&
+             (i = siguiente.fetch_add(1, std::memory_order_relaxed)) < cifrados.size()) {
+        ExtraerLetras(cifrados[i], letras);
+        acumulador.Reiniciar();
+        acumulador.Procesar(letras.data(), letras.size(), 0, letras.size());
+        resultados[i] = acumulador.Resultado(letras.size());
+        const uint64_t* frecuencias = acumulador.Frecuencias();
+        for (size_t letra = 0; letra < 26; ++letra) parcial.frecuencias[letra] += frecuencias[letra];
+        ++parcial.por_longitud[resultados[i].longitud_estimada];
+        parcial.letras += letras.size();
+      }
+    } catch (...) {
+      if (!fallo.exchange(true)) error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> trabajadores;
+  try {
+    for (unsigned i = 1; i < hilos; ++i) trabajadores.emplace_back(trabajador, i);
+  } catch (...) {
+    // No se pudo crear un hilo: los ya creados terminan al ver fallo y se unen abajo.
+    if (!fallo.exchange(true)) error = std::current_exception();
+  }
+  trabajador(0);
+  for (std::thread& hilo : trabajadores) hilo.join();
+  if (error) std::rethrow_exception(error);
+
+  if (resumen != nullptr) {
+    *resumen = ResumenLote();
+    resumen->por_longitud.assign(longitud_maxima + 1, 0);
+    for (const ResumenLote& parcial : parciales) {
+      for (size_t letra = 0; letra < 26; ++letra) resumen->frecuencias[letra] += parcial.frecuencias[letra];
+      for (size_t l = 0; l <= longitud_maxima; ++l) resumen->por_longitud[l] += parcial.por_longitud[l];
+      resumen->letras += parcial.letras;
+    }
+  }
+  return resultados;
+}
+
+/**
+ * @brief Recupera las claves más probables de un texto cifrado con Vigenère.
+ *
+ * Reparte las letras en longitud_clave columnas y puntúa con chi-cuadrado los
+ * 26 desplazamientos de cada una contra las frecuencias del idioma, usando
+ * solo los histogramas: no se descifra el texto para probar cada clave.
+ *
+ * @param cifrado Solo se tienen en cuenta las letras
+ * @param longitud_clave 0 para estimarla (hasta kLongitudMaximaClave)
+ * @param mejores Número de claves que se devuelven
+ * @param idioma
+ * @return std::vector<ClaveCandidata> De mejor a peor (vacío si el texto no tiene letras)
+ */
+std::vector<ClaveCandidata> RecuperarClave(const std::string& cifrado, size_t longitud_clave, size_t mejores,
+                                           Idioma idioma) {
+  ComprobarMejores(mejores);
+  std::vector<uint8_t> letras;
+  ExtraerLetras(cifrado, letras);
+  Acumulador acumulador(kLongitudMaximaClave);
+  std::vector<uint64_t> histogramas;
+  return RecuperarDeLetras(letras, longitud_clave, mejores, FrecuenciasIdioma(idioma), acumulador, histogramas);
+}
+
+/**
+ * @brief Recupera las claves de muchos textos cifrados repartidos entre varios hilos.
+ *
+ * Igual que AnalizarLote, cada hilo toma textos de un contador compartido y
+ * reutiliza sus propios buffers.
+ *
+ * @param cifrados
+ * @param longitud_clave 0 para estimarla en cada texto
+ * @param mejores Claves por texto
+ * @param idioma
+ * @param hilos 0 para usar todos los núcleos disponibles
+ * @return std::vector<std::vector<ClaveCandidata>> Las claves de cada texto, en el mismo orden
+ */
+std::vector<std::vector<ClaveCandidata>> RecuperarLote(const std::vector<std::string>& cifrados,
+                                                       size_t longitud_clave, size_t mejores, Idioma idioma,
+                                                       unsigned hilos) {
+  ComprobarMejores(mejores);
+  const std::array<double, 26> frecuencias = FrecuenciasIdioma(idioma);
+  std::vector<std::vector<ClaveCandidata>> resultados(cifrados.size());
+  hilos = std::min<size_t>(ResolverHilos(hilos), std::max<size_t>(1, cifrados.size()));
+  std::atomic<size_t> siguiente(0);
+  std::atomic<bool> fallo(false);
+  std::exception_ptr error;
+
+  auto trabajador = [&]() {
+    try {
+      Acumulador acumulador(kLongitudMaximaClave);
+      std::vector<uint8_t> letras;
+      std::vector<uint64_t> histogramas;
+      size_t i;
+      while (!fallo.load(std::memory_order_relaxed) &&
+             (i = siguiente.fetch_add(1, std::memory_order_relaxed)) < cifrados.size()) {
+        ExtraerLetras(cifrados[i], letras);
+        resultados[i] = RecuperarDeLetras(letras, longitud_clave, mejores, frecuencias, acumulador, histogramas);
+      }
+    } catch (...) {
+      if (!fallo.exchange(true)) error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> trabajadores;
+  try {
+    for (unsigned i = 1; i < hilos; ++i) trabajadores.emplace_back(trabajador);
+  } catch (...) {
+    // No se pudo crear un hilo: los ya creados terminan al ver fallo y se unen abajo.
+    if (!fallo.exchange(true)) error = std::current_exception();
+  }
+  trabajador();
+  for (std::thread& hilo : trabajadores) hilo.join();
+  if (error) std::rethrow_exception(error);
+  return resultados;
+}
@@ -0,0 +1,106 @@
+#include "../include/flujo.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Lee hasta llenar el buffer o llegar al final de la entrada.
+ *
+ * Una tubería puede devolver lecturas parciales; se insiste para que todos los
+ * trozos salvo el último tengan el tamaño completo.
+ *
+ * @return size_t Bytes leídos (0 al final de la entrada)
+ */
+size_t LeerTrozo(int fd, char* buffer, size_t tamano) {
+  size_t leidos = 0;
+  while (leidos < tamano) {
+    ssize_t n = read(fd, buffer + leidos, tamano - leidos);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Error de lectura: ") + std::strerror(errno));
+    }
+    if (n == 0) break;
+    leidos += static_cast<size_t>(n);
+  }
+  return leidos;
+}
+
+/**
+ * @brief Escribe el buffer completo, reintentando las escrituras parciales.
+ */
+void EscribirTrozo(int fd, const char* buffer, size_t tamano) {
+  size_t escritos = 0;
+  while (escritos < tamano) {
+    ssize_t n = write(fd, buffer + escritos, tamano - escritos);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Error de escritura: ") + std::strerror(errno));
+    }
+    escritos += static_cast<size_t>(n);
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Cifra o descifra la entrada por trozos de tamaño fijo.
+ *
+ * Entre un trozo y el siguiente solo se conserva el EstadoVigenere (fase de
+ * la clave y letras del bloque actual), así que la memoria usada no depende
+ * del tamaño de la entrada y la salida es idéntica byte a byte a la de
+ * CifrarVigenere, DescifrarVigenere o CifradoModificacion sobre todo el texto.
+ *
+ * @param entrada Descriptor de lectura (fichero o tubería)
+ * @param salida Descriptor de escritura
+ * @param clave
+ * @param operacion
+ * @param tamano_bloque Letras por bloque separadas por espacios (0 = sin bloques)
+ * @param nucleo ProcesarVigenere (A-Z) o el de otro alfabeto, p. ej.
+ *               ProcesarVigenereAlfabeto<AlfabetoCastellano>
+ * @return size_t Caracteres escritos
+ */
+size_t ProcesarFlujo(int entrada, int salida, const std::string& clave, Operacion operacion,
+                     size_t tamano_bloque, FuncionVigenere nucleo) {
+  std::vector<char> trozo(kTamanoTrozoFlujo);
+  // Un carácter más: el trozo puede empezar con el espacio de un bloque ya lleno.
+  std::vector<char> resultado(CapacidadSalida(kTamanoTrozoFlujo, tamano_bloque) + 1);
+  EstadoVigenere estado;
+  // Un trozo vacío valida la clave antes de leer, aunque la entrada no tenga nada.
+  nucleo(trozo.data(), 0, clave, operacion, resultado.data(), tamano_bloque, estado);
+  size_t total = 0, leidos;
+  while ((leidos = LeerTrozo(entrada, trozo.data(), trozo.size())) > 0) {
+    const size_t escritos = nucleo(trozo.data(), leidos, clave, operacion, resultado.data(), tamano_bloque, estado);
+    EscribirTrozo(salida, resultado.data(), escritos);
+    total += escritos;
+  }
+  return total;
+}
+
+/**
+ * @brief Modo flujo con clave continua: la clave avanza por el libro a la vez que el texto.
+ *
+ * @param entrada Descriptor de lectura (fichero o tubería)
+ * @param salida Descriptor de escritura
+ * @param clave Libro proyectado; al terminar, clave.Posicion() indica hasta dónde se ha usado
+ * @param operacion
+ * @param tamano_bloque Letras por bloque separadas por espacios (0 = sin bloques)
+ * @return size_t Caracteres escritos
+ */
+size_t ProcesarFlujo(int entrada, int salida, ClaveContinua& clave, Operacion operacion, size_t tamano_bloque) {
+  std::vector<char> trozo(kTamanoTrozoFlujo);
+  std::vector<char> resultado(CapacidadSalida(kTamanoTrozoFlujo, tamano_bloque) + 1);
+  EstadoVigenere estado;
+  size_t total = 0, leidos;
+  while ((leidos = LeerTrozo(entrada, trozo.data(), trozo.size())) > 0) {
+    const size_t escritos = clave.Procesar(trozo.data(), leidos, operacion, resultado.data(), tamano_bloque, estado);
+    EscribirTrozo(salida, resultado.data(), escritos);
+    total += escritos;
+  }
+  return total;
+}
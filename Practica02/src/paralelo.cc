@@ -0,0 +1,166 @@
+#include "../include/paralelo.h"
+#include "../include/mapeo.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Escribe el buffer completo en una posición del fichero.
+ */
+void EscribirEnPosicion(int fd, const char* buffer, size_t tamano, size_t posicion) {
+  size_t escritos = 0;
+  while (escritos < tamano) {
+    ssize_t n = pwrite(fd, buffer + escritos, tamano - escritos, static_cast<off_t>(posicion + escritos));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Error de escritura: ") + std::strerror(errno));
+    }
+    escritos += static_cast<size_t>(n);
+  }
+}
+
+/**
+ * @brief Reparte los segmentos entre los hilos con un contador compartido.
+ *
+ * Se llama a procesar(segmento, hilo) una vez por segmento. Si un hilo
+ * falla, los demás dejan de tomar segmentos y se relanza la primera excepción.
+ */
+template <typename Funcion>
+void Repartir(unsigned hilos, size_t segmentos, Funcion procesar) {
+  std::atomic<size_t> siguiente(0);
+  std::atomic<bool> fallo(false);
+  std::exception_ptr error;
+  auto trabajador = [&](unsigned hilo) {
+    try {
+      size_t segmento;
+      while (!fallo.load(std::memory_order_relaxed) &&
+             (segmento = siguiente.fetch_add(1, std::memory_order_relaxed)) < segmentos) {
+        procesar(segmento, hilo);
+      }
+    } catch (...) {
+      if (!fallo.exchange(true)) error = std::current_exception();
+    }
+  };
+  std::vector<std::thread> trabajadores;
+  try {
+    for (unsigned i = 1; i < hilos && i < segmentos; ++i) trabajadores.emplace_back(trabajador, i);
+  } catch (...) {
+    // No se pudo crear un hilo: los ya creados terminan al ver fallo y se unen abajo.
+    if (!fallo.exchange(true)) error = std::current_exception();
+  }
+  trabajador(0);
+  for (std::thread& hilo : trabajadores) hilo.join();
+  if (error) std::rethrow_exception(error);
+}
+
+/**
+ * @brief Caracteres de salida que ocupan las primeras letras del texto.
+ *
+ * Con bloques, hay un espacio delante de cada letra cuya posición es
+ * múltiplo de tamano_bloque, salvo la primera.
+ */
+size_t SalidaDeLetras(size_t letras, size_t tamano_bloque) {
+  if (tamano_bloque == 0 || letras == 0) return letras;
+  return letras + (letras - 1) / tamano_bloque;
+}
+
+}  // namespace
+
+/**
+ * @brief Cifra o descifra un fichero repartiendo segmentos entre varios hilos.
+ *
+ * En Vigenère la letra de clave de cada letra depende de cuántas letras hay
+ * antes, no de su posición en bytes. Por eso se hacen dos pasadas:
+ *   1. Cada hilo cuenta las letras de los segmentos que toma.
+ *   2. La suma acumulada de esos recuentos da, para cada segmento, su fase de
+ *      clave, su posición dentro del bloque y su desplazamiento en la salida.
+ *      Con ese estado cada segmento se cifra por separado y se escribe con
+ *      pwrite en su sitio, de modo que la salida es la misma que la del modo
+ *      flujo o la de CifrarVigenere sobre todo el texto.
+ *
+ * @param ruta_entrada Fichero regular (se proyecta en memoria)
+ * @param ruta_salida Se crea o se trunca; no puede ser la entrada
+ * @param clave
+ * @param operacion
+ * @param tamano_bloque Letras por bloque separadas por espacios (0 = sin bloques)
+ * @param hilos 0 para usar todos los núcleos disponibles
+ * @param nucleo Núcleo del alfabeto (ProcesarVigenere para A-Z)
+ * @param contar Recuento de letras del mismo alfabeto
+ * @return size_t Caracteres escritos
+ */
+size_t ProcesarParalelo(const std::string& ruta_entrada, const std::string& ruta_salida, const std::string& clave,
+                        Operacion operacion, size_t tamano_bloque, unsigned hilos, FuncionVigenere nucleo,
+                        FuncionContarLetras contar) {
+  // Un texto vacío valida la clave antes de tocar la salida.
+  EstadoVigenere estado_vacio;
+  nucleo(nullptr, 0, clave, operacion, nullptr, tamano_bloque, estado_vacio);
+
+  ArchivoMapeado entrada(ruta_entrada);
+  const char* texto = reinterpret_cast<const char*>(entrada.Datos());
+  const size_t tamano = entrada.Tamano();
+  const size_t segmentos = (tamano + kTamanoSegmento - 1) / kTamanoSegmento;
+  if (hilos == 0) hilos = std::thread::hardware_concurrency();
+  if (hilos == 0) hilos = 1;
+
+  // Pasada 1: letras de cada segmento.
+  std::vector<size_t> letras_previas(segmentos + 1, 0);
+  Repartir(hilos, segmentos, [&](size_t segmento, unsigned) {
+    const size_t inicio = segmento * kTamanoSegmento;
+    letras_previas[segmento + 1] = contar(texto + inicio, std::min(kTamanoSegmento, tamano - inicio));
+  });
+  for (size_t segmento = 0; segmento < segmentos; ++segmento) {
+    letras_previas[segmento + 1] += letras_previas[segmento];
+  }
+  const size_t total = SalidaDeLetras(letras_previas[segmentos], tamano_bloque);
+
+  // Sin O_TRUNC: si la salida fuera la entrada, se vaciaría mientras sigue proyectada.
+  int salida = open(ruta_salida.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (salida < 0) {
+    throw std::runtime_error("No se puede abrir " + ruta_salida + ": " + std::strerror(errno));
+  }
+  if (entrada.MismoArchivo(salida)) {
+    close(salida);
+    throw std::invalid_argument("La entrada y la salida son el mismo fichero");
+  }
+  if (ftruncate(salida, static_cast<off_t>(total)) < 0) {
+    int error = errno;
+    close(salida);
+    throw std::runtime_error("No se puede redimensionar " + ruta_salida + ": " + std::strerror(error));
+  }
+
+  // Pasada 2: cada segmento empieza con el estado que le dan las letras anteriores.
+  std::vector<std::vector<char>> buffers(std::min<size_t>(hilos, std::max<size_t>(segmentos, 1)));
+  try {
+    Repartir(hilos, segmentos, [&](size_t segmento, unsigned hilo) {
+      std::vector<char>& buffer = buffers[hilo];
+      // Un carácter más por si el segmento empieza con el espacio de un bloque lleno.
+      buffer.resize(CapacidadSalida(kTamanoSegmento, tamano_bloque) + 1);
+      const size_t previas = letras_previas[segmento];
+      EstadoVigenere estado;
+      estado.fase = previas % clave.size();
+      if (tamano_bloque != 0 && previas != 0) estado.en_bloque = (previas - 1) % tamano_bloque + 1;
+      const size_t inicio = segmento * kTamanoSegmento;
+      const size_t escritos = nucleo(texto + inicio, std::min(kTamanoSegmento, tamano - inicio), clave, operacion,
+                                     buffer.data(), tamano_bloque, estado);
+      EscribirEnPosicion(salida, buffer.data(), escritos, SalidaDeLetras(previas, tamano_bloque));
+    });
+  } catch (...) {
+    close(salida);
+    throw;
+  }
+  if (close(salida) < 0) {
+    throw std::runtime_error("Error al cerrar " + ruta_salida + ": " + std::strerror(errno));
+  }
+  return total;
+}
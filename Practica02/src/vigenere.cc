@@ -0,0 +1,192 @@
+#include "../include/vigenere.h"
+#include "../include/alfabeto.h"
+#include "../include/vigenere_simd.h"
+
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Ejecuta el núcleo sobre un std::string y devuelve el resultado ajustado.
+ */
+std::string ProcesarTexto(const std::string& texto, const std::string& clave, Operacion operacion,
+                          size_t tamano_bloque) {
+  std::string salida(CapacidadSalida(texto.size(), tamano_bloque), '\0');
+  salida.resize(ProcesarVigenere(texto.data(), texto.size(), clave, operacion, &salida[0], tamano_bloque));
+  return salida;
+}
+
+}  // namespace
+
+/**
+ * @brief Comprueba que la clave no está vacía y solo contiene letras (A-Z o a-z).
+ *
+ * @param clave
+ */
+void ComprobarClave(const std::string& clave) { ComprobarClaveAlfabeto<AlfabetoLatino>(clave); }
+
+/**
+ * @brief Tamaño de buffer suficiente para la salida de ProcesarVigenere.
+ *
+ * Como mucho cada carácter del texto es una letra, más un espacio por bloque.
+ *
+ * @param longitud_texto
+ * @param tamano_bloque 0 si no se agrupa en bloques
+ * @return size_t
+ */
+size_t CapacidadSalida(size_t longitud_texto, size_t tamano_bloque) {
+  return longitud_texto + (tamano_bloque == 0 ? 0 : longitud_texto / tamano_bloque);
+}
+
+/**
+ * @brief Núcleo de Vigenère escalar: una sola pasada, sin reservas de memoria.
+ *
+ * Para cada letra del texto (en mayúsculas, entre 0 y 25) se toma la letra de
+ * la clave que le toca, se combinan según la operación y se escribe el
+ * resultado. Sustituye a generar una clave ajustada tan larga como el texto,
+ * concatenar carácter a carácter y formatear en bloques en una copia aparte.
+ * Es el recorrido por tablas del alfabeto A-Z (ver alfabeto.h), así que no
+ * depende del locale.
+ *
+ * @param texto
+ * @param longitud
+ * @param clave Solo letras, no vacía (ya validada)
+ * @param operacion
+ * @param salida Buffer de al menos CapacidadSalida(longitud, tamano_bloque) caracteres
+ * @param tamano_bloque Letras por bloque separadas por espacios (0 = sin bloques)
+ * @param estado Fase de la clave y del bloque al empezar; se actualiza al terminar
+ * @return size_t Caracteres escritos en salida
+ */
+size_t ProcesarVigenereEscalar(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                               char* salida, size_t tamano_bloque, EstadoVigenere& estado) {
+  switch (operacion) {
+    case Operacion::kCifrar:
+      return RecorrerAlfabeto<AlfabetoLatino, Operacion::kCifrar>(texto, longitud, clave, salida, tamano_bloque,
+                                                                estado);
+    case Operacion::kDescifrar:
+      return RecorrerAlfabeto<AlfabetoLatino, Operacion::kDescifrar>(texto, longitud, clave, salida, tamano_bloque,
+                                                                   estado);
+    case Operacion::kModificacion:
+      return RecorrerAlfabeto<AlfabetoLatino, Operacion::kModificacion>(texto, longitud, clave, salida, tamano_bloque,
+                                                                      estado);
+  }
+  return 0;
+}
+
+/**
+ * @brief Lista las implementaciones soportadas, de la más sencilla a la más ancha.
+ *
+ * @return std::vector<ImplementacionVigenere>
+ */
+std::vector<ImplementacionVigenere> ImplementacionesVigenere() {
+  std::vector<ImplementacionVigenere> lista = {{"escalar", ProcesarVigenereEscalar}};
+#ifdef VIGENERE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("ssse3")) {
+    lista.push_back({"sse", ProcesarVigenereSse});
+    if (__builtin_cpu_supports("avx2")) lista.push_back({"avx2", ProcesarVigenereAvx2});
+  }
+#endif
+  return lista;
+}
+
+namespace {
+
+// Se resuelve una única vez al arrancar el programa.
+const ImplementacionVigenere kVigenereActivo = ImplementacionesVigenere().back();
+
+}  // namespace
+
+const char* NombreVigenereActivo() { return kVigenereActivo.nombre; }
+
+/**
+ * @brief Núcleo de Vigenère con la implementación elegida al arrancar.
+ *
+ * Lanza std::invalid_argument si la clave está vacía o contiene algo que no
+ * sea una letra.
+ *
+ * @param texto
+ * @param longitud
+ * @param clave
+ * @param operacion
+ * @param salida Buffer de al menos CapacidadSalida(longitud, tamano_bloque) caracteres
+ * @param tamano_bloque Letras por bloque separadas por espacios (0 = sin bloques)
+ * @return size_t Caracteres escritos en salida
+ */
+size_t ProcesarVigenere(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                        char* salida, size_t tamano_bloque) {
+  EstadoVigenere estado;
+  return ProcesarVigenere(texto, longitud, clave, operacion, salida, tamano_bloque, estado);
+}
+
+/**
+ * @brief Núcleo de Vigenère que continúa donde lo dejó la llamada anterior.
+ *
+ * Procesar un texto por trozos pasando siempre el mismo estado da
+ * exactamente la misma salida que procesarlo entero de una vez. El buffer
+ * necesita un carácter más que CapacidadSalida, por si el trozo empieza con
+ * el espacio de un bloque que ya estaba lleno.
+ *
+ * @param estado Empieza a cero para un texto nuevo; se actualiza al terminar
+ * @return size_t Caracteres escritos en salida
+ */
+size_t ProcesarVigenere(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                        char* salida, size_t tamano_bloque, EstadoVigenere& estado) {
+  ComprobarClave(clave);
+  if (estado.fase >= clave.size()) throw std::invalid_argument("La fase no cabe en la clave");
+  return kVigenereActivo.funcion(texto, longitud, clave, operacion, salida, tamano_bloque, estado);
+}
+
+/**
+ * @brief Función para cifrar el texto usando el cifrado de Vigenere.
+ *
+ * Cifrado de Vigenere:
+ *   1. Convertimos el carácter a mayúsculas para evitar problemas con el cifrado
+ *   2. Restamos el valor ASCII de la letra 'A' para obtener un valor entre 0 y 25
+ *   3. Sumamos el valor de la letra de la clave que le corresponde
+ *   4. Si la suma supera 'Z' (25), restamos 26 para volver al inicio del alfabeto
+ *   5. Sumamos el valor ASCII de la letra 'A' para convertir el número de vuelta en un carácter alfabético
+ *   6. Convertimos el valor ASCII a carácter
+ * El resultado se agrupa en bloques del tamaño de la clave.
+ * Ejemplo: texto = "MENSAJESECRETO", clave = "CLAVE" -> bloques de 5 letras
+ *
+ * @param texto
+ * @param clave
+ * @return std::string
+ */
+std::string CifrarVigenere(const std::string &texto, const std::string &clave) {
+  return ProcesarTexto(texto, clave, Operacion::kCifrar, clave.size());
+}
+
+/**
+ * @brief Función MODIFICACI
+ *
+ * Resta el valor de la letra del texto al de la clave (módulo 26), sin bloques.
+ *
+ * @param texto
+ * @param clave
+ * @return std::string
+ */
+std::string CifradoModificacion(const std::string& texto, const std::string& clave) {
+  return ProcesarTexto(texto, clave, Operacion::kModificacion, 0);
+}
+
+/**
+ * @brief Función para descifrar el texto usando el cifrado de Vigenere.
+ *
+ * Descifrado de Vigenere:
+ *  1. Convertimos el carácter a mayúsculas para evitar problemas con el cifrado
+ *  2. Restamos el carácter de la clave que le corresponde al carácter del texto cifrado para obtener el valor original
+ *  3. Puesto que el número puede ser negativo, sumamos 26 para obtener un valor positivo
+ *  4. Si el resultado supera 'Z' (25), restamos 26 para volver al inicio del alfabeto
+ *  5. Sumamos el valor ASCII de la letra 'A' para convertir el número de vuelta en un carácter alfabético
+ *  6. Convertimos el valor ASCII a carácter
+ * Los espacios de los bloques no son letras, así que no avanzan la clave.
+ *
+ * @param cifrado
+ * @param clave
+ * @return std::string
+ */
+std::string DescifrarVigenere(const std::string &cifrado, const std::string &clave) {
+  return ProcesarTexto(cifrado, clave, Operacion::kDescifrar, clave.size());
+}
@@ -0,0 +1,253 @@
+#include "../include/vigenere_simd.h"
+
+#ifdef VIGENERE_X86
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// Letras que se compactan y combinan de una vez; caben en la caché L1.
+const size_t kTesela = 4096;
+// Margen tras la tesela: la compactación escribe 8 bytes aunque valgan menos.
+const size_t kMargenTesela = 16;
+// Clave más larga que se extiende en la pila; con claves más largas (que
+// Vigenère no necesita en la práctica) se usa el núcleo escalar.
+const size_t kClaveMaximaVectorial = 4096;
+
+/**
+ * @brief Genera en compilación los patrones de compactación para pshufb.
+ *
+ * Para cada máscara de 8 bits, los índices de los bits a 1 en orden; el resto
+ * de posiciones se rellena con 0x80 (pshufb escribe un cero).
+ *
+ * @return std::array<std::array<uint8_t, 8>, 256>
+ */
+constexpr std::array<std::array<uint8_t, 8>, 256> GenerarPatrones() {
+  std::array<std::array<uint8_t, 8>, 256> patrones = {};
+  for (int mascara = 0; mascara < 256; ++mascara) {
+    int k = 0;
+    for (int bit = 0; bit < 8; ++bit) {
+      if (mascara & (1 << bit)) patrones[mascara][k++] = static_cast<uint8_t>(bit);
+    }
+    for (; k < 8; ++k) patrones[mascara][k] = 0x80;
+  }
+  return patrones;
+}
+
+constexpr std::array<std::array<uint8_t, 8>, 256> kPatrones = GenerarPatrones();
+
+/**
+ * @brief Valor de una letra ASCII (0..25) o 26 o más si no es una letra.
+ *
+ * Quitar el bit 0x20 pasa las minúsculas a mayúsculas; restando 'A' las
+ * letras quedan entre 0 y 25 y todo lo demás, como entero sin signo, fuera.
+ */
+inline uint8_t ValorLetra(unsigned char c) { return static_cast<uint8_t>((c & 0xDF) - 'A'); }
+
+/**
+ * @brief Compactación vectorial: deja en letras los valores (0..25) de las letras del texto.
+ *
+ * Cada iteración clasifica 16 caracteres con una resta y una comparación sin
+ * signo. Si todos son letras se guardan tal cual; si no, pshufb con el patrón
+ * de cada mitad de la máscara junta las letras al principio.
+ *
+ * @return size_t Número de letras
+ */
+__attribute__((target("ssse3")))
+size_t CompactarLetras(const char* texto, size_t longitud, uint8_t* letras) {
+  const __m128i mayusculas = _mm_set1_epi8(static_cast<char>(0xDF));
+  const __m128i a = _mm_set1_epi8('A');
+  const __m128i z = _mm_set1_epi8(25);
+  const __m128i ocho = _mm_set1_epi8(8);
+  size_t n = 0, i = 0;
+  for (; i + 16 <= longitud; i += 16) {
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(texto + i));
+    __m128i valor = _mm_sub_epi8(_mm_and_si128(c, mayusculas), a);
+    __m128i es_letra = _mm_cmpeq_epi8(_mm_min_epu8(valor, z), valor);
+    const int mascara = _mm_movemask_epi8(es_letra);
+    if (mascara == 0xFFFF) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(letras + n), valor);
+      n += 16;
+      continue;
+    }
+    if (mascara == 0) continue;
+    const int baja = mascara & 0xFF, alta = mascara >> 8;
+    __m128i patron_bajo = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(kPatrones[baja].data()));
+    __m128i patron_alto = _mm_add_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(kPatrones[alta].data())), ocho);
+    __m128i juntas = _mm_shuffle_epi8(valor, _mm_unpacklo_epi64(patron_bajo, patron_alto));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(letras + n), juntas);
+    n += static_cast<size_t>(__builtin_popcount(baja));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(letras + n), _mm_unpackhi_epi64(juntas, juntas));
+    n += static_cast<size_t>(__builtin_popcount(alta));
+  }
+  for (; i < longitud; ++i) {
+    const uint8_t valor = ValorLetra(static_cast<unsigned char>(texto[i]));
+    if (valor < 26) letras[n++] = valor;
+  }
+  return n;
+}
+
+/**
+ * @brief Combinación escalar de una letra con su valor de clave ya preparado.
+ *
+ * Cifrar y descifrar suman (clave o 26 - clave); la modificación resta la
+ * letra de clave + 26. En todos los casos basta con comparar y restar 26.
+ */
+template <Operacion kOperacion>
+inline char CombinarLetra(uint8_t letra, uint8_t clave) {
+  int valor = kOperacion == Operacion::kModificacion ? clave - letra : clave + letra;
+  return static_cast<char>('A' + (valor >= 26 ? valor - 26 : valor));
+}
+
+/**
+ * @brief Prepara la clave para la operación y la repite hasta cubrir un vector completo.
+ *
+ * Cargando desde extendida + fase se obtiene, sin ninguna operación módulo,
+ * el patrón de clave rotado que corresponde a las 32 letras siguientes.
+ *
+ * @param clave
+ * @param operacion
+ * @param extendida Buffer de la longitud de la clave + 32 valores
+ */
+void ExtenderClave(const std::string& clave, Operacion operacion, uint8_t* extendida) {
+  for (size_t i = 0; i < clave.size() + 32; ++i) {
+    const uint8_t valor = ValorLetra(static_cast<unsigned char>(clave[i % clave.size()]));
+    switch (operacion) {
+      case Operacion::kCifrar: extendida[i] = valor; break;
+      case Operacion::kDescifrar: extendida[i] = static_cast<uint8_t>(26 - valor); break;
+      case Operacion::kModificacion: extendida[i] = static_cast<uint8_t>(26 + valor); break;
+    }
+  }
+}
+
+/**
+ * @brief Combinación SSE2: 16 letras por instrucción.
+ *
+ * La reducción módulo 26 es min(v, v - 26) sin signo: si v < 26 la resta da
+ * la vuelta a un valor mayor y el mínimo se queda con v.
+ */
+template <Operacion kOperacion>
+__attribute__((target("sse2")))
+void CombinarSse2(uint8_t* letras, size_t n, const uint8_t* clave, size_t longitud_clave, size_t& fase) {
+  const __m128i veintiseis = _mm_set1_epi8(26);
+  const __m128i a = _mm_set1_epi8('A');
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(letras + i));
+    __m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(clave + fase));
+    __m128i v = kOperacion == Operacion::kModificacion ? _mm_sub_epi8(k, t) : _mm_add_epi8(k, t);
+    v = _mm_min_epu8(v, _mm_sub_epi8(v, veintiseis));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(letras + i), _mm_add_epi8(v, a));
+    fase = (fase + 16) % longitud_clave;
+  }
+  for (; i < n; ++i) {
+    letras[i] = static_cast<uint8_t>(CombinarLetra<kOperacion>(letras[i], clave[fase]));
+    if (++fase == longitud_clave) fase = 0;
+  }
+}
+
+/**
+ * @brief Combinación AVX2: 32 letras por instrucción (misma aritmética que SSE2).
+ */
+template <Operacion kOperacion>
+__attribute__((target("avx2")))
+void CombinarAvx2(uint8_t* letras, size_t n, const uint8_t* clave, size_t longitud_clave, size_t& fase) {
+  const __m256i veintiseis = _mm256_set1_epi8(26);
+  const __m256i a = _mm256_set1_epi8('A');
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i t = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(letras + i));
+    __m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(clave + fase));
+    __m256i v = kOperacion == Operacion::kModificacion ? _mm256_sub_epi8(k, t) : _mm256_add_epi8(k, t);
+    v = _mm256_min_epu8(v, _mm256_sub_epi8(v, veintiseis));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(letras + i), _mm256_add_epi8(v, a));
+    fase = (fase + 32) % longitud_clave;
+  }
+  CombinarSse2<kOperacion>(letras + i, n - i, clave, longitud_clave, fase);
+}
+
+using FuncionCombinar = void (*)(uint8_t*, size_t, const uint8_t*, size_t, size_t&);
+
+/**
+ * @brief Copia las letras ya cifradas a la salida, intercalando los espacios de los bloques.
+ */
+void Emitir(const uint8_t* letras, size_t n, char* salida, size_t& escritos, size_t& en_bloque,
+            size_t tamano_bloque) {
+  if (tamano_bloque == 0) {
+    std::memcpy(salida + escritos, letras, n);
+    escritos += n;
+    return;
+  }
+  while (n > 0) {
+    if (en_bloque == tamano_bloque) {
+      salida[escritos++] = ' ';
+      en_bloque = 0;
+    }
+    const size_t tramo = std::min(n, tamano_bloque - en_bloque);
+    std::memcpy(salida + escritos, letras, tramo);
+    escritos += tramo;
+    en_bloque += tramo;
+    letras += tramo;
+    n -= tramo;
+  }
+}
+
+/**
+ * @brief Recorrido por teselas: compactar, combinar y emitir cada trozo del texto.
+ *
+ * El texto se lee una sola vez; las tres etapas trabajan sobre una tesela que
+ * permanece en la caché L1. La clave extendida y la tesela están en la pila,
+ * así que cada llamada (cada trozo del modo flujo o segmento del paralelo)
+ * no reserva memoria.
+ */
+size_t ProcesarPorTeselas(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                          char* salida, size_t tamano_bloque, EstadoVigenere& estado, FuncionCombinar combinar) {
+  if (clave.size() > kClaveMaximaVectorial) {
+    return ProcesarVigenereEscalar(texto, longitud, clave, operacion, salida, tamano_bloque, estado);
+  }
+  uint8_t clave_extendida[kClaveMaximaVectorial + 32];
+  ExtenderClave(clave, operacion, clave_extendida);
+  uint8_t tesela[kTesela + kMargenTesela];
+  size_t escritos = 0;
+  for (size_t i = 0; i < longitud; i += kTesela) {
+    const size_t n = CompactarLetras(texto + i, std::min(kTesela, longitud - i), tesela);
+    combinar(tesela, n, clave_extendida, clave.size(), estado.fase);
+    Emitir(tesela, n, salida, escritos, estado.en_bloque, tamano_bloque);
+  }
+  return escritos;
+}
+
+}  // namespace
+
+/**
+ * @brief Vigenère vectorial con SSSE3 (compactación) y SSE2 (combinación).
+ *
+ * Misma interfaz y resultado que ProcesarVigenereEscalar. La clave ya está validada.
+ */
+size_t ProcesarVigenereSse(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                           char* salida, size_t tamano_bloque, EstadoVigenere& estado) {
+  FuncionCombinar combinar = operacion == Operacion::kCifrar      ? CombinarSse2<Operacion::kCifrar>
+                             : operacion == Operacion::kDescifrar ? CombinarSse2<Operacion::kDescifrar>
+                                                                  : CombinarSse2<Operacion::kModificacion>;
+  return ProcesarPorTeselas(texto, longitud, clave, operacion, salida, tamano_bloque, estado, combinar);
+}
+
+/**
+ * @brief Vigenère vectorial con SSSE3 (compactación) y AVX2 (combinación).
+ *
+ * Misma interfaz y resultado que ProcesarVigenereEscalar. La clave ya está validada.
+ */
+size_t ProcesarVigenereAvx2(const char* texto, size_t longitud, const std::string& clave, Operacion operacion,
+                            char* salida, size_t tamano_bloque, EstadoVigenere& estado) {
+  FuncionCombinar combinar = operacion == Operacion::kCifrar      ? CombinarAvx2<Operacion::kCifrar>
+                             : operacion == Operacion::kDescifrar ? CombinarAvx2<Operacion::kDescifrar>
+                                                                  : CombinarAvx2<Operacion::kModificacion>;
+  return ProcesarPorTeselas(texto, longitud, clave, operacion, salida, tamano_bloque, estado, combinar);
+}
+
+#endif  // VIGENERE_X86
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "chacha20.h"
+#include "poly1305.h"
+
+/**
+ * @brief ChaCha20-Poly1305 (RFC 8439, 2.8) por trozos.
+ *
+ * La clave de Poly1305 es el principio del bloque 0 de ChaCha20; el texto se
+ * cifra desde el bloque 1. El MAC cubre los datos asociados, el cifrado y sus
+ * longitudes, cada parte rellenada con ceros hasta un múltiplo de 16. Con un
+ * nonce de 24 bytes es XChaCha20-Poly1305.
+ *
+ * Los datos asociados deben añadirse antes del primer update. Al abrir, update
+ * devuelve texto aún no autenticado: no debe usarse hasta que finishOpen
+ * termine sin lanzar.
+ */
+class ChaCha20Poly1305 {
+ public:
+  enum Mode { kSeal, kOpen };
+
+  ChaCha20Poly1305(const std::vector<uint8_t>& key, const std::vector<uint8_t>& nonce, Mode mode);
+
+  void addAad(const uint8_t* data, size_t length);
+  void update(const uint8_t* input, uint8_t* output, size_t length);
+  void finishSeal(uint8_t* tag);
+  void finishOpen(const uint8_t* tag);
+
+ private:
+  void startText();
+  void finish(uint8_t* tag);
+
+  ChaCha20 cipher_;
+  Poly1305 mac_;
+  Mode mode_;
+  uint64_t aadLength_;
+  uint64_t textLength_;
+  bool textStarted_;
+  bool finished_;
+};
+
+std::vector<uint8_t> aeadSeal(const std::vector<uint8_t>& key, const std::vector<uint8_t>& nonce,
+                              const std::vector<uint8_t>& plaintext, const std::vector<uint8_t>& aad = {});
+std::vector<uint8_t> aeadOpen(const std::vector<uint8_t>& key, const std::vector<uint8_t>& nonce,
+                              const std::vector<uint8_t>& sealed, const std::vector<uint8_t>& aad = {});
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// Constantes de ChaCha20 ("expand 32-byte k"), sin memoria dinámica ni inicialización al arrancar.
+constexpr std::array<uint32_t, 4> kConstants = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+
+const size_t kKeySize = 32;    // 256 bits
+const size_t kNonceSize = 12;  // 96 bits
+const size_t kHNonceSize = 16;  // 128 bits (HChaCha20)
+const size_t kXNonceSize = 24;  // 192 bits (XChaCha20)
+const size_t kBlockSize = 64;  // Bytes de keystream por bloque
+// Bloques que genera de una vez el cifrador de flujo (los 512 bytes de AVX2).
+const size_t kBatchBlocks = 8;
+// Mensajes independientes que se cifran a la vez en el modo multi-buffer (un carril AVX2 por mensaje).
+const size_t kLanes = 8;
+
+// Firma común de los generadores de keystream (escalar, SSE2, AVX2): escriben
+// `blocks` bloques consecutivos, con contadores state[12], state[12] + 1, ...
+using KeystreamFunction = void (*)(const uint32_t* state, uint8_t* keystream, size_t blocks);
+
+struct KeystreamImplementation {
+  const char* name;
+  KeystreamFunction function;
+};
+
+// Variantes de ChaCha según el número de rondas. ChaCha12 y ChaCha8 son más
+// rápidas y bastan donde se acepta menos margen de seguridad (enlaces internos).
+enum ChaChaRounds { kChaCha8 = 8, kChaCha12 = 12, kChaCha20 = 20 };
+
+// Estado de 16 palabras sin memoria dinámica.
+using ChaCha20State = std::array<uint32_t, 16>;
+
+// Gancho opcional de depuración: recibe un texto y el estado de 16 palabras.
+using TraceFunction = void (*)(const char* text, const uint32_t* state);
+
+std::vector<uint8_t> generateRandomNonce(size_t size = kNonceSize);
+
+uint32_t rotl(uint32_t value, uint32_t shift);
+void quarterRound(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d);
+std::vector<uint32_t> initializeState(const std::vector<uint8_t>& key, uint32_t counter,
+                                      const std::vector<uint8_t>& nonce,
+                                      const std::array<uint32_t, 4>& constants = kConstants);
+// Rondas, bloque y generador escalar con kRounds = 8, 12 o 20 (instanciados en chacha20.cc).
+template <int kRounds>
+void chachaRounds(uint32_t* state);
+template <int kRounds>
+void chachaBlock(const uint32_t* state, uint8_t* keystream);
+template <int kRounds>
+void chachaKeystreamScalar(const uint32_t* state, uint8_t* keystream, size_t blocks);
+
+void chacha20Rounds(uint32_t* state);
+void chacha20Rounds(std::vector<uint32_t>& state);
+void chacha20Block(const uint32_t* state, uint8_t* keystream);
+void chacha20Block(const std::vector<uint32_t>& state, uint8_t* keystream);
+void printState(const std::string& text, const std::vector<uint32_t>& state);
+void printState(const char* text, const uint32_t* state);
+
+// HChaCha20 y estado de XChaCha20 (nonce de 24 bytes) o ChaCha20 (12 bytes) según el nonce.
+std::vector<uint8_t> hchacha20(const std::vector<uint8_t>& key, const std::vector<uint8_t>& nonce);
+std::vector<uint32_t> initializeStreamState(const std::vector<uint8_t>& key, uint32_t counter,
+                                            const std::vector<uint8_t>& nonce);
+void initializeStreamState(ChaCha20State& state, std::span<const uint8_t> key, uint32_t counter,
+                           std::span<const uint8_t> nonce);
+
+// Generador de keystream con la mejor implementación disponible, elegida al
+// arrancar según CPUID.
+void chacha20Keystream(const uint32_t* state, uint8_t* keystream, size_t blocks);
+std::vector<KeystreamImplementation> keystreamImplementations(ChaChaRounds rounds = kChaCha20);
+const char* activeKeystreamName();
+KeystreamFunction activeKeystream(ChaChaRounds rounds);
+
+std::vector<uint8_t> chacha20Encrypt(const std::vector<uint8_t>& plaintext, const std::vector<uint8_t>& key,
+                                     uint32_t counter, const std::vector<uint8_t>& nonce);
+
+/**
+ * @brief Cifrador de flujo ChaCha20 (RFC 8439) para mensajes de cualquier longitud.
+ *
+ * El keystream se genera solo cuando hace falta, kBatchBlocks bloques de una
+ * vez, y se combina en el sitio con los datos; el contador (palabra 12 del
+ * estado) avanza con cada bloque. Lo que sobra de un bloque se guarda para la siguiente llamada,
+ * así que trocear un mensaje no cambia el resultado y la memoria usada no
+ * depende de su longitud.
+ *
+ * Con un nonce de 24 bytes el cifrador es XChaCha20: la clave se deriva con
+ * HChaCha20, lo que permite usar nonces aleatorios sin temer colisiones.
+ *
+ * El número de rondas se elige al crear el contexto (ChaCha20, ChaCha12 o
+ * ChaCha8); cada variante tiene sus propios generadores desenrollados. La
+ * subclave de XChaCha se deriva siempre con las 20 rondas de HChaCha20.
+ *
+ * El contexto no reserva memoria dinámica: el estado es un std::array y la
+ * clave se guarda ya en palabras, de modo que reset() lo prepara para otro
+ * mensaje (otro nonce) sin volver a leerla. Para cifrar muchos paquetes
+ * pequeños basta un contexto por clave.
+ */
+class ChaCha20 {
+ public:
+  ChaCha20(std::span<const uint8_t> key, std::span<const uint8_t> nonce, uint32_t counter = 0,
+           ChaChaRounds rounds = kChaCha20);
+
+  // Empieza otro mensaje con la misma clave.
+  void reset(std::span<const uint8_t> nonce, uint32_t counter = 0);
+
+  void xorInPlace(std::span<uint8_t> data);
+  void xorTo(std::span<const uint8_t> input, std::span<uint8_t> output);
+  void process(uint8_t* data, size_t length);
+  void process(const uint8_t* input, uint8_t* output, size_t length);
+
+  // Salta a un byte cualquiera del keystream: el bloque se calcula directamente desde su contador.
+  void seek(uint64_t offset);
+
+  // Bytes de keystream consumidos desde el contador inicial.
+  uint64_t position() const { return position_; }
+
+  ChaChaRounds rounds() const { return rounds_; }
+
+  // Llama a trace con el estado inicial y con el de cada tanda (nullptr lo desactiva).
+  void setTrace(TraceFunction trace) { trace_ = trace; }
+
+ private:
+  void refill();
+
+  KeystreamFunction generator_;  // Generador de la variante elegida
+  ChaChaRounds rounds_;
+  std::array<uint32_t, 8> key_;
+  ChaCha20State state_;
+  uint32_t counter_;    // Contador del primer bloque (posición 0)
+  alignas(32) uint8_t keystream_[kBatchBlocks * kBlockSize];
+  size_t available_;    // Bytes válidos en keystream_
+  size_t used_;         // Bytes de keystream_ ya consumidos
+  uint64_t position_;
+  uint64_t remaining_;  // Bloques que quedan antes de que el contador dé la vuelta
+  TraceFunction trace_;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../include/chacha20.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CHACHA20_X86 1
+
+// Generadores vectoriales: calculan 4 (SSE2) u 8 (AVX2) bloques a la vez, con
+// cada palabra del estado en un registro y un bloque por carril. kRounds es 8,
+// 12 o 20 (instanciados en chacha20_simd.cc).
+template <int kRounds>
+void chachaKeystreamSse2(const uint32_t* state, uint8_t* keystream, size_t blocks);
+template <int kRounds>
+void chachaKeystreamAvx2(const uint32_t* state, uint8_t* keystream, size_t blocks);
+
+// Multi-buffer: un bloque de cada uno de kLanes estados distintos (un mensaje por carril).
+void chacha20LanesSse2(const uint32_t* lanes, uint8_t* keystream);
+void chacha20LanesAvx2(const uint32_t* lanes, uint8_t* keystream);
+#endif
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief Generador de números aleatorios criptográficamente seguro basado en ChaCha20.
+ *
+ * La clave inicial se toma de getrandom(). Cada tanda de keystream usa los
+ * bloques 1, 2, ... como salida y el bloque 0 como clave siguiente ("fast key
+ * erasure"): la clave anterior se borra, así que comprometer el estado no
+ * revela la salida ya entregada. Los bytes del buffer también se borran al
+ * entregarlos, y las peticiones grandes se generan directamente en el destino.
+ *
+ * Cada hilo tiene su propio generador (threadLocal()), por lo que no hay
+ * bloqueos ni contención entre hilos.
+ */
+class Csprng {
+ public:
+  Csprng();
+  ~Csprng();
+
+  Csprng(const Csprng&) = delete;
+  Csprng& operator=(const Csprng&) = delete;
+
+  // Generador del hilo actual, creado la primera vez que se usa.
+  static Csprng& threadLocal();
+
+  void fill(std::span<uint8_t> output);
+  void fill(uint8_t* output, size_t length);
+
+  // Entero uniforme en [0, bound), sin el sesgo de rand() % bound.
+  uint64_t uniform(uint64_t bound);
+
+  // Gancho de pruebas: el bloque interno con clave (32 bytes) y nonce (12) arbitrarios.
+  static void testBlock(const uint8_t* key, uint32_t counter, const uint8_t* nonce, uint8_t* output);
+
+ private:
+  static const size_t kCsprngBlocks = 16;
+
+  void refill();
+  void generate(uint8_t* output, size_t blocks);
+
+  uint32_t key_[8];
+  uint8_t buffer_[kCsprngBlocks * 64];
+  size_t used_;  // Bytes de buffer_ ya entregados (y borrados)
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include "aead.h"
+#include "chacha20.h"
+#include "mapeo.h"
+
+// Tamaño del trozo que se lee, cifra y escribe en cada iteración del modo flujo.
+const size_t kChunkSize = 1 << 20;
+
+size_t encryptStream(int input, int output, ChaCha20& cipher);
+
+// Modo autenticado: el cifrado va seguido de la etiqueta de 16 bytes.
+size_t sealStream(int input, int output, ChaCha20Poly1305& aead);
+size_t openStream(int input, int output, ChaCha20Poly1305& aead);
+
+// Acceso aleatorio: descifra [offset, offset + longitud) de un fichero cifrado sin
+// descifrar lo anterior, a partir del contador del bloque que contiene offset.
+void checkRange(const ArchivoMapeado& file, uint64_t offset, uint64_t length);
+void decryptRange(const ArchivoMapeado& file, ChaCha20& cipher, uint64_t offset, std::span<uint8_t> output);
+size_t decryptRange(ArchivoMapeado& file, ChaCha20& cipher, uint64_t offset, uint64_t length, int output);
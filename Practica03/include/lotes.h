@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../include/chacha20.h"
+
+/**
+ * @brief Un mensaje del modo multi-buffer: se cifra (o descifra) en el sitio.
+ *
+ * Cada mensaje tiene su propia clave, nonce y contador; las claves y los
+ * datos no se copian, así que deben seguir vivos hasta que acabe la llamada.
+ */
+struct ChaCha20Job {
+  std::span<const uint8_t> key;    // 32 bytes
+  std::span<const uint8_t> nonce;  // 12 bytes (ChaCha20) o 24 (XChaCha20)
+  uint32_t counter;                // Contador del primer bloque
+  std::span<uint8_t> data;
+};
+
+// Firma de los generadores multi-buffer: un bloque de cada uno de kLanes
+// estados independientes, con lanes[w * kLanes + l] la palabra w del carril l.
+using LanesFunction = void (*)(const uint32_t* lanes, uint8_t* keystream);
+
+struct LanesImplementation {
+  const char* name;
+  LanesFunction function;
+};
+
+void chacha20LanesScalar(const uint32_t* lanes, uint8_t* keystream);
+std::vector<LanesImplementation> lanesImplementations();
+const char* activeLanesName();
+
+void chacha20Batch(std::span<ChaCha20Job> jobs);
+void chacha20Batch(std::span<ChaCha20Job> jobs, LanesFunction lanes);
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Tamaño de los trozos que reparten los hilos: múltiplo de 64, así que cada
+// trozo empieza al principio de un bloque de ChaCha20.
+const size_t kSegmentSize = 4 << 20;
+
+size_t encryptParallel(const std::string& inputPath, const std::string& outputPath, const std::vector<uint8_t>& key,
+                       const std::vector<uint8_t>& nonce, uint32_t counter, unsigned threads = 0);
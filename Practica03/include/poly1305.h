@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+const size_t kPoly1305KeySize = 32;
+const size_t kPoly1305TagSize = 16;
+const size_t kPoly1305BlockSize = 16;
+
+/**
+ * @brief Poly1305 (RFC 8439) incremental.
+ *
+ * El acumulador y r se guardan en 3 limbs de 44, 44 y 42 bits dentro de
+ * palabras de 64 bits; cada bloque cuesta 9 productos de 64x64 -> 128 bits.
+ * Con mensajes largos y AVX2 se procesan 4 bloques a la vez con las
+ * potencias r^1..r^4 (ver poly1305_simd.h).
+ */
+class Poly1305 {
+ public:
+  // key: 32 bytes, r || s. Una clave no debe usarse para más de un mensaje.
+  explicit Poly1305(const uint8_t* key);
+
+  void update(const uint8_t* data, size_t length);
+  // Completa con ceros hasta el siguiente múltiplo de 16 (relleno de RFC 8439, 2.8).
+  void pad();
+  void finish(uint8_t* tag);
+
+ private:
+  void blocks(const uint8_t* data, size_t count);
+  void preparePowers();
+
+  uint64_t r_[3];
+  uint64_t h_[3];
+  uint64_t s_[2];
+  uint64_t powers_[4][3];   // r^1..r^4 totalmente reducidas, para el camino vectorial
+  bool powersReady_;
+  uint8_t buffer_[kPoly1305BlockSize];
+  size_t buffered_;
+};
+
+bool constantTimeEqual(const uint8_t* a, const uint8_t* b, size_t length);
+const char* activePoly1305Name();
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#define POLY1305_X86 1
+
+// Procesa los bloques de 16 bytes en grupos de 4, uno por carril, con limbs de
+// 26 bits. h (3 limbs de 44 bits) entra y sale en el formato escalar;
+// powers[k] es r^(k+1) totalmente reducida en ese mismo formato.
+// Devuelve los bloques procesados (múltiplo de 4).
+size_t poly1305BlocksAvx2(uint64_t* h, const uint64_t (*powers)[3], const uint8_t* data, size_t blocks);
+#endif
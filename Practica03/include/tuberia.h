@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Tamaño de cada buffer del anillo de la tubería: múltiplo de 64, así que cada
+// trozo empieza al principio de un bloque de ChaCha20.
+const size_t kPipelineChunkSize = 1 << 20;
+
+// E/S de la tubería: io_uring si se puede (al compilar y al ejecutar) o pread/pwrite.
+enum IoBackend { kIoAutomatic, kIoPread };
+
+bool ioUringAvailable();
+
+size_t encryptPipeline(const std::string& inputPath, const std::string& outputPath, const std::vector<uint8_t>& key,
+                       const std::vector<uint8_t>& nonce, uint32_t counter, unsigned workers = 0,
+                       IoBackend backend = kIoAutomatic);
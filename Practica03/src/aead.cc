@@ -0,0 +1,171 @@
+#include "../include/aead.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Trozo con el que se alternan cifrado y MAC, para que el MAC lea el cifrado
+// mientras aún está en la caché.
+const size_t kInterleaveSize = 16 << 10;
+
+/**
+ * @brief Clave de un solo uso de Poly1305: los 32 primeros bytes del bloque 0.
+ *
+ * Consume el bloque 0 entero, así que el cifrador queda en el bloque 1.
+ */
+std::vector<uint8_t> oneTimeKey(ChaCha20& cipher) {
+  std::vector<uint8_t> block(kBlockSize, 0);
+  cipher.process(block.data(), block.size());
+  block.resize(kPoly1305KeySize);
+  return block;
+}
+
+void updateLength(Poly1305& mac, uint64_t length) {
+  uint8_t bytes[8];
+  for (int i = 0; i < 8; ++i) bytes[i] = static_cast<uint8_t>(length >> (8 * i));
+  mac.update(bytes, sizeof(bytes));
+}
+
+}  // namespace
+
+/**
+ * @brief Constructor: genera la clave de Poly1305 con el contador 0.
+ *
+ * @param key 32 bytes
+ * @param nonce 12 bytes, o 24 para XChaCha20-Poly1305; no debe repetirse nunca con la misma clave
+ * @param mode kSeal (cifrar y autenticar) o kOpen (verificar y descifrar)
+ */
+ChaCha20Poly1305::ChaCha20Poly1305(const std::vector<uint8_t>& key, const std::vector<uint8_t>& nonce, Mode mode)
+    : cipher_(key, nonce, 0),
+      mac_(oneTimeKey(cipher_).data()),
+      mode_(mode),
+      aadLength_(0),
+      textLength_(0),
+      textStarted_(false),
+      finished_(false) {}
+
+/**
+ * @brief Añade datos asociados: se autentican pero no se cifran.
+ *
+ * @param data
+ * @param length
+ */
+void ChaCha20Poly1305::addAad(const uint8_t* data, size_t length) {
+  if (textStarted_ || finished_) throw std::logic_error("Los datos asociados van antes del texto");
+  mac_.update(data, length);
+  aadLength_ += length;
+}
+
+void ChaCha20Poly1305::startText() {
+  if (finished_) throw std::logic_error("El mensaje ya está cerrado");
+  if (!textStarted_) {
+    mac_.pad();
+    textStarted_ = true;
+  }
+}
+
+/**
+ * @brief Cifra (kSeal) o descifra (kOpen) un trozo; input y output pueden coincidir.
+ *
+ * El MAC siempre se calcula sobre el cifrado: al sellar, después de cifrar;
+ * al abrir, antes de descifrar. Se alterna por trozos de kInterleaveSize.
+ *
+ * @param input
+ * @param output
+ * @param length
+ */
+void ChaCha20Poly1305::update(const uint8_t* input, uint8_t* output, size_t length) {
+  startText();
+  for (size_t done = 0; done < length; done += kInterleaveSize) {
+    const size_t take = std::min(kInterleaveSize, length - done);
+    if (mode_ == kSeal) {
+      cipher_.process(input + done, output + done, take);
+      mac_.update(output + done, take);
+    } else {
+      mac_.update(input + done, take);
+      cipher_.process(input + done, output + done, take);
+    }
+  }
+  textLength_ += length;
+}
+
+void ChaCha20Poly1305::finish(uint8_t* tag) {
+  startText();
+  mac_.pad();
+  updateLength(mac_, aadLength_);
+  updateLength(mac_, textLength_);
+  mac_.finish(tag);
+  finished_ = true;
+}
+
+/**
+ * @brief Cierra el mensaje sellado y escribe la etiqueta.
+ *
+ * @param tag 16 bytes
+ */
+void ChaCha20Poly1305::finishSeal(uint8_t* tag) {
+  if (mode_ != kSeal) throw std::logic_error("finishSeal solo sirve para sellar");
+  finish(tag);
+}
+
+/**
+ * @brief Cierra el mensaje abierto y comprueba la etiqueta en tiempo constante.
+ *
+ * Lanza std::runtime_error si no coincide; en ese caso el texto descifrado
+ * hasta ahora debe descartarse.
+ *
+ * @param tag 16 bytes
+ */
+void ChaCha20Poly1305::finishOpen(const uint8_t* tag) {
+  if (mode_ != kOpen) throw std::logic_error("finishOpen solo sirve para abrir");
+  uint8_t expected[kPoly1305TagSize];
+  finish(expected);
+  if (!constantTimeEqual(expected, tag, kPoly1305TagSize)) {
+    throw std::runtime_error("La etiqueta no coincide: el mensaje no es auténtico");
+  }
+}
+
+/**
+ * @brief Cifra y autentica un mensaje completo.
+ *
+ * @param key
+ * @param nonce
+ * @param plaintext
+ * @param aad Datos asociados
+ * @return std::vector<uint8_t> Cifrado seguido de la etiqueta de 16 bytes
+ */
+std::vector<uint8_t> aeadSeal(const std::vector<uint8_t>& key, const std::vector<uint8_t>& nonce,
+                              const std::vector<uint8_t>& plaintext, const std::vector<uint8_t>& aad) {
+  ChaCha20Poly1305 aead(key, nonce, ChaCha20Poly1305::kSeal);
+  aead.addAad(aad.data(), aad.size());
+  std::vector<uint8_t> sealed(plaintext.size() + kPoly1305TagSize);
+  aead.update(plaintext.data(), sealed.data(), plaintext.size());
+  aead.finishSeal(sealed.data() + plaintext.size());
+  return sealed;
+}
+
+/**
+ * @brief Verifica y descifra un mensaje sellado con aeadSeal.
+ *
+ * Lanza std::runtime_error si el mensaje o los datos asociados se han
+ * modificado; en ese caso no se devuelve nada del texto.
+ *
+ * @param key
+ * @param nonce
+ * @param sealed Cifrado seguido de la etiqueta
+ * @param aad Datos asociados
+ * @return std::vector<uint8_t> Texto en claro
+ */
+std::vector<uint8_t> aeadOpen(const std::vector<uint8_t>& key, const std::vector<uint8_t>& nonce,
+                              const std::vector<uint8_t>& sealed, const std::vector<uint8_t>& aad) {
+  if (sealed.size() < kPoly1305TagSize) throw std::runtime_error("El mensaje es más corto que la etiqueta");
+  const size_t length = sealed.size() - kPoly1305TagSize;
+  ChaCha20Poly1305 aead(key, nonce, ChaCha20Poly1305::kOpen);
+  aead.addAad(aad.data(), aad.size());
+  std::vector<uint8_t> plaintext(length);
+  aead.update(sealed.data(), plaintext.data(), length);
+  aead.finishOpen(sealed.data() + length);
+  return plaintext;
+}
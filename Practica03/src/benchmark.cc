@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../include/aead.h"
+#include "../include/chacha20.h"
+#include "../include/chacha20_simd.h"
+#include "../include/lotes.h"
+#include "../include/paralelo.h"
+#include "../include/tuberia.h"
+
+// Bytes que se procesan en cada medida, repitiendo la llamada si hace falta.
+const size_t kBytesPerMeasure = size_t(256) << 20;
+
+/**
+ * @brief Repite una función hasta procesar kBytesPerMeasure y devuelve los MB/s.
+ */
+template <typename Function>
+double measure(size_t length, Function function) {
+  size_t repetitions = kBytesPerMeasure / length;
+  if (repetitions == 0) repetitions = 1;
+  function();
+  auto start = std::chrono::steady_clock::now();
+  for (size_t r = 0; r < repetitions; ++r) function();
+  std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+  return double(length) * double(repetitions) / seconds.count() / 1e6;
+}
+
+#ifdef CHACHA20_X86
+#include <x86intrin.h>
+
+/**
+ * @brief Como measure, pero devuelve ciclos por byte según el contador de la CPU (rdtsc).
+ *
+ * rdtsc cuenta ciclos a la frecuencia nominal: con turbo o ahorro de energía
+ * el valor difiere algo de los ciclos reales, pero sirve para comparar.
+ */
+template <typename Function>
+double cyclesPerByte(size_t length, Function function) {
+  size_t repetitions = kBytesPerMeasure / length;
+  if (repetitions == 0) repetitions = 1;
+  function();
+  const uint64_t start = __rdtsc();
+  for (size_t r = 0; r < repetitions; ++r) function();
+  return double(__rdtsc() - start) / (double(length) * double(repetitions));
+}
+
+/**
+ * @brief Ciclos/byte de ChaCha8, ChaCha12 y ChaCha20 con cada generador y con el cifrador de flujo.
+ *
+ * @param length Bytes por llamada
+ */
+void benchmarkRounds(size_t length) {
+  const std::vector<uint8_t> key(kKeySize, 0x42), nonce(kNonceSize, 0x24);
+  const std::vector<uint32_t> state = initializeState(key, 1, nonce);
+  const size_t blocks = (length + kBlockSize - 1) / kBlockSize;
+  std::vector<uint8_t> buffer(blocks * kBlockSize);
+  std::cout << "Implementación activa: " << activeKeystreamName() << ", " << length << " bytes por llamada"
+            << std::endl << std::endl;
+  std::cout << "Ciclos/byte" << std::endl;
+  std::cout << std::setw(12) << "Variante";
+  for (const KeystreamImplementation& impl : keystreamImplementations()) std::cout << std::setw(12) << impl.name;
+  std::cout << std::setw(12) << "cifrado" << std::endl;
+  for (ChaChaRounds rounds : {kChaCha8, kChaCha12, kChaCha20}) {
+    std::cout << std::setw(12) << "ChaCha" + std::to_string(rounds) << std::fixed << std::setprecision(2);
+    for (const KeystreamImplementation& impl : keystreamImplementations(rounds)) {
+      std::cout << std::setw(12) << cyclesPerByte(length, [&] { impl.function(state.data(), buffer.data(), blocks); });
+    }
+    ChaCha20 context(key, nonce, 1, rounds);
+    std::cout << std::setw(12) << cyclesPerByte(length, [&] {
+      context.reset(nonce, 1);
+      context.xorInPlace(std::span<uint8_t>(buffer.data(), length));
+    });
+    std::cout << std::endl;
+  }
+}
+#endif
+
+/**
+ * @brief MB/s de cada generador de keystream, del cifrado (nuevo o con el contexto reutilizado), de Poly1305
+ * y de ChaCha20-Poly1305.
+ *
+ * @param maximum Tamaño del mensaje más grande
+ */
+void benchmarkImplementations(size_t maximum) {
+  const std::vector<uint8_t> key(kKeySize, 0x42), nonce(kNonceSize, 0x24);
+  const std::vector<uint32_t> state = initializeState(key, 1, nonce);
+  std::vector<uint8_t> buffer(maximum + kBlockSize);
+  std::vector<KeystreamImplementation> implementations = keystreamImplementations();
+  uint8_t tag[kPoly1305TagSize];
+  ChaCha20 context(key, nonce, 1);
+
+  std::cout << "Implementación activa: " << activeKeystreamName() << ", Poly1305: " << activePoly1305Name()
+            << std::endl << std::endl;
+  std::cout << "MB/s" << std::endl;
+  std::cout << std::setw(12) << "Tamaño";
+  for (const KeystreamImplementation& impl : implementations) std::cout << std::setw(12) << impl.name;
+  std::cout << std::setw(12) << "cifrado" << std::setw(12) << "contexto" << std::setw(12) << "poly1305"
+            << std::setw(12) << "aead" << std::endl;
+  for (size_t length = 64; length <= maximum; length *= 16) {
+    const size_t blocks = (length + kBlockSize - 1) / kBlockSize;
+    std::cout << std::setw(12) << length << std::fixed << std::setprecision(1);
+    for (const KeystreamImplementation& impl : implementations) {
+      std::cout << std::setw(12) << measure(length, [&] { impl.function(state.data(), buffer.data(), blocks); });
+    }
+    // Cifrado en el sitio con el cifrador de flujo (implementación activa).
+    std::cout << std::setw(12) << measure(length, [&] {
+      ChaCha20 cipher(key, nonce, 1);
+      cipher.process(buffer.data(), length);
+    });
+    // Un contexto por clave reutilizado con reset(), como al cifrar muchos paquetes.
+    std::cout << std::setw(12) << measure(length, [&] {
+      context.reset(nonce, 1);
+      context.xorInPlace(std::span<uint8_t>(buffer.data(), length));
+    });
+    std::cout << std::setw(12) << measure(length, [&] {
+      Poly1305 mac(key.data());
+      mac.update(buffer.data(), length);
+      mac.finish(tag);
+    });
+    // ChaCha20-Poly1305: el MAC no debería reducir mucho la velocidad del cifrado solo.
+    std::cout << std::setw(12) << measure(length, [&] {
+      ChaCha20Poly1305 aead(key, nonce, ChaCha20Poly1305::kSeal);
+      aead.update(buffer.data(), buffer.data(), length);
+      aead.finishSeal(tag);
+    });
+    std::cout << std::endl;
+  }
+}
+
+/**
+ * @brief Millones de mensajes por segundo del modo multi-buffer frente a cifrarlos uno a uno.
+ *
+ * Cada mensaje tiene su propio nonce. Se prueban lotes de count mensajes de
+ * 64, 128, 256 y 512 bytes, y uno con tamaños mezclados entre 64 y 512. "uno
+ * a uno" reutiliza un contexto con reset(), el camino más rápido sin lotes.
+ *
+ * @param count Mensajes por lote
+ */
+void benchmarkBatch(size_t count) {
+  const std::vector<uint8_t> key(kKeySize, 0x42);
+  std::cout << "Implementación activa: " << activeLanesName() << ", " << count << " mensajes por lote" << std::endl
+            << std::endl;
+  std::vector<LanesImplementation> implementations = lanesImplementations();
+  std::cout << "Millones de mensajes/s" << std::endl;
+  std::cout << std::setw(12) << "Tamaño" << std::setw(12) << "uno a uno";
+  for (const LanesImplementation& impl : implementations) std::cout << std::setw(12) << impl.name;
+  std::cout << std::endl;
+
+  std::vector<std::vector<uint8_t>> nonces(count, std::vector<uint8_t>(kNonceSize));
+  for (size_t i = 0; i < count; ++i) std::memcpy(nonces[i].data(), &i, sizeof(i));
+  for (size_t size : {size_t(64), size_t(128), size_t(256), size_t(512), size_t(0)}) {
+    // Tamaño 0: mezclados, de 64 a 512 bytes.
+    std::vector<size_t> sizes(count, size);
+    if (size == 0) {
+      for (size_t i = 0; i < count; ++i) sizes[i] = 64 + (i * 197) % 449;
+    }
+    std::vector<size_t> offsets(count + 1, 0);
+    for (size_t i = 0; i < count; ++i) offsets[i + 1] = offsets[i] + sizes[i];
+    const size_t total = offsets[count];
+    std::vector<uint8_t> buffer(total);
+    std::vector<ChaCha20Job> jobs(count);
+    for (size_t i = 0; i < count; ++i) {
+      jobs[i] = {key, nonces[i], 1, std::span<uint8_t>(buffer.data() + offsets[i], sizes[i])};
+    }
+    // MB/s entre bytes por mensaje = millones de mensajes por segundo.
+    const double average = double(total) / double(count);
+    if (size == 0) {
+      std::cout << std::setw(12) << "64-512";
+    } else {
+      std::cout << std::setw(12) << size;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    ChaCha20 context(key, nonces[0], 1);
+    std::cout << std::setw(12) << measure(total, [&] {
+      for (ChaCha20Job& job : jobs) {
+        context.reset(job.nonce, job.counter);
+        context.xorInPlace(job.data);
+      }
+    }) / average;
+    for (const LanesImplementation& impl : implementations) {
+      std::cout << std::setw(12) << measure(total, [&] { chacha20Batch(jobs, impl.function); }) / average;
+    }
+    std::cout << std::endl;
+  }
+}
+
+/**
+ * @brief Crea en /tmp un fichero del tamaño indicado.
+ *
+ * @param size
+ * @return std::string Ruta del fichero
+ */
+std::string createTemporary(size_t size) {
+  char path[] = "/tmp/chacha20_benchmark_XXXXXX";
+  int fd = mkstemp(path);
+  if (fd < 0) throw std::runtime_error(std::string("No se puede crear el temporal: ") + std::strerror(errno));
+  std::vector<uint8_t> chunk(std::min(size, kSegmentSize));
+  for (size_t i = 0; i < chunk.size(); ++i) chunk[i] = static_cast<uint8_t>(i * 131 + 7);
+  for (size_t written = 0; written < size;) {
+    ssize_t n = write(fd, chunk.data(), std::min(chunk.size(), size - written));
+    if (n < 0) {
+      int error = errno;
+      close(fd);
+      throw std::runtime_error(std::string("Error de escritura: ") + std::strerror(error));
+    }
+    written += static_cast<size_t>(n);
+  }
+  close(fd);
+  return path;
+}
+
+/**
+ * @brief Benchmark de escalado del modo paralelo, de 1 a maxThreads hilos.
+ *
+ * Se prueban ficheros de 16 MiB hasta size, multiplicando por 4. Para cada
+ * tamaño y número de hilos se toma la mejor de 3 ejecuciones (tras la
+ * primera, la entrada ya está en la caché de páginas).
+ *
+ * @param size Bytes del fichero más grande
+ * @param maxThreads
+ */
+void benchmarkParallel(size_t size, unsigned maxThreads) {
+  const std::vector<uint8_t> key(kKeySize, 0x42), nonce(kNonceSize, 0x24);
+  std::cout << "Implementación activa: " << activeKeystreamName() << ", trozos de " << kSegmentSize << " bytes"
+            << std::endl;
+  for (size_t length = std::min(size, size_t(16) << 20); length <= size; length *= 4) {
+    const std::string input = createTemporary(length);
+    const std::string output = input + ".cifrado";
+    std::cout << std::endl << "Entrada de " << length << " bytes" << std::endl;
+    std::cout << std::setw(8) << "Hilos" << std::setw(12) << "MB/s" << std::setw(14) << "Aceleración" << std::endl;
+    double base = 0;
+    for (unsigned threads = 1; threads <= maxThreads; ++threads) {
+      double best = 0;
+      for (int repetition = 0; repetition < 3; ++repetition) {
+        auto start = std::chrono::steady_clock::now();
+        encryptParallel(input, output, key, nonce, 1, threads);
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        best = std::max(best, double(length) / seconds.count() / 1e6);
+      }
+      if (threads == 1) base = best;
+      std::cout << std::setw(8) << threads << std::setw(12) << std::fixed << std::setprecision(1) << best
+                << std::setw(11) << std::setprecision(2) << best / base << "x" << std::endl;
+    }
+    unlink(input.c_str());
+    unlink(output.c_str());
+  }
+}
+
+/**
+ * @brief MB/s de la tubería (pread/pwrite e io_uring) frente al modo paralelo, con los mismos hilos.
+ *
+ * Mejor de 3 ejecuciones por fichero; la entrada ya está en la caché de
+ * páginas, así que mide sobre todo el solapamiento y el coste de las
+ * llamadas al sistema, no el del disco.
+ *
+ * @param size Bytes del fichero
+ * @param threads
+ */
+void benchmarkPipeline(size_t size, unsigned threads) {
+  const std::vector<uint8_t> key(kKeySize, 0x42), nonce(kNonceSize, 0x24);
+  const std::string input = createTemporary(size);
+  const std::string output = input + ".cifrado";
+  std::cout << "Entrada de " << size << " bytes, " << threads << " hilos de cifrado, io_uring "
+            << (ioUringAvailable() ? "disponible" : "no disponible") << std::endl << std::endl;
+  auto best = [&](auto function) {
+    double result = 0;
+    for (int repetition = 0; repetition < 3; ++repetition) {
+      auto start = std::chrono::steady_clock::now();
+      function();
+      std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+      result = std::max(result, double(size) / seconds.count() / 1e6);
+    }
+    return result;
+  };
+  std::cout << std::setw(22) << "Modo" << std::setw(12) << "MB/s" << std::endl << std::fixed << std::setprecision(1);
+  std::cout << std::setw(22) << "paralelo (mmap)"
+            << std::setw(12) << best([&] { encryptParallel(input, output, key, nonce, 1, threads); }) << std::endl;
+  std::cout << std::setw(22) << "tubería pread/pwrite" << std::setw(12)
+            << best([&] { encryptPipeline(input, output, key, nonce, 1, threads, kIoPread); }) << std::endl;
+  if (ioUringAvailable()) {
+    std::cout << std::setw(22) << "tubería io_uring" << std::setw(12)
+              << best([&] { encryptPipeline(input, output, key, nonce, 1, threads, kIoAutomatic); }) << std::endl;
+  }
+  unlink(input.c_str());
+  unlink(output.c_str());
+}
+
+/**
+ * @brief Benchmarks de ChaCha20.
+ *
+ * Uso:
+ *   ./benchmark [nucleos] [tamano_maximo]    MB/s de cada generador por tamaño (por defecto hasta 16 MiB)
+ *   ./benchmark paralelo [tamano] [hilos]    escalado de 1 a N hilos, ficheros de 16 MiB a tamano
+ *                                            (por defecto 1 GiB, todos los núcleos)
+ *   ./benchmark lotes [mensajes]             mensajes/s del modo multi-buffer frente a uno a uno
+ *                                            (por defecto lotes de 4096 mensajes)
+ *   ./benchmark tuberia [tamano] [hilos]     MB/s de la tubería frente al modo paralelo
+ *                                            (por defecto 256 MiB, todos los núcleos)
+ *   ./benchmark rondas [tamano]              ciclos/byte de ChaCha8, ChaCha12 y ChaCha20 (x86;
+ *                                            por defecto 16 KiB por llamada)
+ */
+int main(int argc, char* argv[]) {
+  std::string mode = argc > 1 ? argv[1] : "nucleos";
+  int first = 2;
+  if (mode != "nucleos" && mode != "paralelo" && mode != "lotes" && mode != "rondas" &&
+      mode != "tuberia") {
+    mode = "nucleos";
+    first = 1;
+  }
+  try {
+    if (mode == "paralelo" || mode == "tuberia") {
+      size_t size = mode == "paralelo" ? size_t(1) << 30 : size_t(256) << 20;
+      if (argc > first) size = std::strtoull(argv[first], nullptr, 10);
+      unsigned threads = std::thread::hardware_concurrency();
+      if (argc > first + 1) threads = static_cast<unsigned>(std::strtoul(argv[first + 1], nullptr, 10));
+      if (size == 0 || threads == 0) {
+        std::cerr << "El tamaño y el número de hilos deben ser positivos" << std::endl;
+        return 1;
+      }
+      if (mode == "paralelo") {
+        benchmarkParallel(size, threads);
+      } else {
+        benchmarkPipeline(size, threads);
+      }
+    } else if (mode == "lotes") {
+      size_t count = 4096;
+      if (argc > first) count = std::strtoull(argv[first], nullptr, 10);
+      if (count == 0) {
+        std::cerr << "El número de mensajes debe ser positivo" << std::endl;
+        return 1;
+      }
+      benchmarkBatch(count);
+    } else if (mode == "rondas") {
+#ifdef CHACHA20_X86
+      size_t length = 16 << 10;
+      if (argc > first) length = std::strtoull(argv[first], nullptr, 10);
+      if (length == 0) {
+        std::cerr << "El tamaño debe ser positivo" << std::endl;
+        return 1;
+      }
+      benchmarkRounds(length);
+#else
+      std::cerr << "La medida de ciclos usa rdtsc y solo está disponible en x86" << std::endl;
+      return 1;
+#endif
+    } else {
+      size_t maximum = size_t(16) << 20;
+      if (argc > first) maximum = std::strtoull(argv[first], nullptr, 10);
+      if (maximum < kBlockSize) {
+        std::cerr << "El tamaño máximo debe ser de al menos 64 bytes" << std::endl;
+        return 1;
+      }
+      benchmarkImplementations(maximum);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
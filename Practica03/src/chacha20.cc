@@ -0,0 +1,572 @@
+#include "../include/chacha20.h"
+#include "../include/chacha20_simd.h"
+#include "../include/csprng.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#include <string.h>
+
+/**
+ * @brief Función que genera un nonce aleatorio.
+ *
+ * Los bytes salen del generador ChaCha20 del hilo (Csprng), sembrado con
+ * getrandom(): a diferencia de srand(time(nullptr)) y rand(), dos ejecuciones
+ * en el mismo segundo no dan el mismo nonce ni se puede predecir a partir de la hora.
+ *
+ * @param size kNonceSize (96 bits) o kXNonceSize (192 bits)
+ * @return std::vector<uint8_t>
+ */
+std::vector<uint8_t> generateRandomNonce(size_t size) {
+  std::vector<uint8_t> nonce(size);
+  Csprng::threadLocal().fill(nonce);
+  return nonce;
+}
+
+/**
+ * @brief Función que realiza la operación de rotación a la izquierda.
+ *
+ * @param value
+ * @param shift
+ * @return uint32_t
+ */
+uint32_t rotl(uint32_t value, uint32_t shift) {
+  // Movemos los bits a la izquierda y rellenamos con los bits que se desplazaron.
+  return (value << shift) | (value >> (32 - shift));
+}
+
+/**
+ * @brief Función que realiza la operación QR de ChaCha20.
+ *
+ * @param a
+ * @param b
+ * @param c
+ * @param d
+ */
+void quarterRound(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d) {
+  // ARX: Add Rotate Xor.
+  a += b; d ^= a; d = rotl(d, 16);
+  c += d; b ^= c; b = rotl(b, 12);
+  a += b; d ^= a; d = rotl(d, 8);
+  c += d; b ^= c; b = rotl(b, 7);
+}
+
+/**
+ * @brief Lee una palabra de 32 bits en little-endian.
+ *
+ * @param bytes
+ * @return uint32_t
+ */
+static uint32_t loadLittleEndian(const uint8_t* bytes) {
+  return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+         (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+/**
+ * @brief Función que inicializa el estado de ChaCha20.
+ *
+ * @param key 32 bytes
+ * @param counter
+ * @param nonce 12 bytes
+ * @param constants
+ * @return std::vector<uint32_t>
+ */
+std::vector<uint32_t> initializeState(const std::vector<uint8_t>& key, uint32_t counter,
+                                      const std::vector<uint8_t>& nonce, const std::array<uint32_t, 4>& constants) {
+  if (key.size() != kKeySize) throw std::invalid_argument("La clave debe tener 32 bytes");
+  if (nonce.size() != kNonceSize) throw std::invalid_argument("El nonce debe tener 12 bytes (24 con XChaCha20)");
+
+  // Estado de ChaCha20.
+  std::vector<uint32_t> state(16);
+
+  // Rellenamos las primeras 4 palabras con las constantes.
+  for (int i = 0; i < 4; ++i) {
+    state[i] = constants[i];
+  }
+
+  // Rellenamos las siguientes 8 palabras con la clave en little-endian.
+  for (int i = 0; i < 8; ++i) {
+    state[i + 4] = loadLittleEndian(&key[i * 4]);
+  }
+
+  // Rellenamos la palabra 12 con el contador.
+  state[12] = counter;
+
+  // Rellenamos la palabra 13, 14 y 15 con el nonce en little-endian.
+  for (int i = 0; i < 3; ++i) {
+    state[i + 13] = loadLittleEndian(&nonce[i * 4]);
+  }
+
+  return state;
+}
+
+/**
+ * @brief Función que realiza las kRounds iteraciones de ChaCha (8, 12 o 20).
+ *
+ * El número de rondas es constante de compilación: las kRounds / 2 rondas
+ * dobles se desenrollan por completo, sin contador de bucle.
+ *
+ * @param state 16 palabras
+ */
+template <int kRounds>
+void chachaRounds(uint32_t* state) {
+  static_assert(kRounds == 8 || kRounds == 12 || kRounds == 20, "ChaCha solo admite 8, 12 o 20 rondas");
+  // kRounds iteraciones = kRounds / 2 iteraciones de 2 QRs (par e impar)
+#pragma GCC unroll 10
+  for (int i = 0; i < kRounds / 2; ++i) {
+    // Iteraciones pares: columnas.
+    quarterRound(state[0], state[4], state[8], state[12]);
+    quarterRound(state[1], state[5], state[9], state[13]);
+    quarterRound(state[2], state[6], state[10], state[14]);
+    quarterRound(state[3], state[7], state[11], state[15]);
+
+    // Iteraciones impares: diagonales.
+    quarterRound(state[0], state[5], state[10], state[15]);
+    quarterRound(state[1], state[6], state[11], state[12]);
+    quarterRound(state[2], state[7], state[8], state[13]);
+    quarterRound(state[3], state[4], state[9], state[14]);
+  }
+}
+
+void chacha20Rounds(uint32_t* state) {
+  chachaRounds<20>(state);
+}
+
+void chacha20Rounds(std::vector<uint32_t>& state) {
+  chacha20Rounds(state.data());
+}
+
+/**
+ * @brief Genera un bloque de 64 bytes de keystream a partir de un estado.
+ *
+ * Las rondas se aplican a una copia; el bloque es la suma de la copia final
+ * y el estado de entrada, serializada en little-endian.
+ *
+ * @param state Estado de 16 palabras (no se modifica)
+ * @param keystream Buffer de kBlockSize bytes
+ */
+template <int kRounds>
+void chachaBlock(const uint32_t* state, uint8_t* keystream) {
+  uint32_t working[16];
+  for (int i = 0; i < 16; ++i) working[i] = state[i];
+  chachaRounds<kRounds>(working);
+  // Iteramos sobre las 16 palabras y dividimos cada una en 4 bytes.
+  for (int i = 0; i < 16; ++i) {
+    const uint32_t word = working[i] + state[i];
+    for (int j = 0; j < 4; ++j) {
+      keystream[i * 4 + j] = static_cast<uint8_t>(word >> (8 * j));
+    }
+  }
+  // Con el bloque y el estado de trabajo se recupera la clave: no se deja en la pila (Csprng).
+  explicit_bzero(working, sizeof(working));
+}
+
+void chacha20Block(const uint32_t* state, uint8_t* keystream) {
+  chachaBlock<20>(state, keystream);
+}
+
+void chacha20Block(const std::vector<uint32_t>& state, uint8_t* keystream) {
+  chacha20Block(state.data(), keystream);
+}
+
+/**
+ * @brief Convierte la clave de 32 bytes en 8 palabras little-endian.
+ *
+ * @param key
+ * @param words 8 palabras
+ */
+static void loadKey(std::span<const uint8_t> key, uint32_t* words) {
+  if (key.size() != kKeySize) throw std::invalid_argument("La clave debe tener 32 bytes");
+  for (int i = 0; i < 8; ++i) words[i] = loadLittleEndian(key.data() + 4 * i);
+}
+
+/**
+ * @brief Rellena un estado con las constantes, la clave ya en palabras, el contador y un nonce de 12 bytes.
+ *
+ * Es lo mismo que initializeState, pero sin memoria dinámica.
+ */
+static void fillState(uint32_t* state, const uint32_t* key, uint32_t counter, const uint8_t* nonce) {
+  for (int i = 0; i < 4; ++i) state[i] = kConstants[i];
+  for (int i = 0; i < 8; ++i) state[i + 4] = key[i];
+  state[12] = counter;
+  for (int i = 0; i < 3; ++i) state[i + 13] = loadLittleEndian(nonce + 4 * i);
+}
+
+/**
+ * @brief HChaCha20 sobre palabras: subclave de 8 palabras a partir de la clave y un nonce de 16 bytes.
+ */
+static void hchacha20Words(const uint32_t* key, const uint8_t* nonce, uint32_t* subkey) {
+  uint32_t state[16];
+  fillState(state, key, loadLittleEndian(nonce), nonce + 4);
+  chacha20Rounds(state);
+  const int words[8] = {0, 1, 2, 3, 12, 13, 14, 15};
+  for (int i = 0; i < 8; ++i) subkey[i] = state[words[i]];
+}
+
+/**
+ * @brief Estado inicial de ChaCha20 (nonce de 12 bytes) o de XChaCha20 (24 bytes) sin memoria dinámica.
+ *
+ * @throw std::invalid_argument Si el nonce no tiene 12 ni 24 bytes
+ */
+static void streamState(uint32_t* state, const uint32_t* key, uint32_t counter, std::span<const uint8_t> nonce) {
+  if (nonce.size() == kNonceSize) {
+    fillState(state, key, counter, nonce.data());
+    return;
+  }
+  if (nonce.size() != kXNonceSize) throw std::invalid_argument("El nonce debe tener 12 bytes (24 con XChaCha20)");
+  uint32_t subkey[8];
+  hchacha20Words(key, nonce.data(), subkey);
+  uint8_t shortNonce[kNonceSize] = {0};
+  std::memcpy(shortNonce + 4, nonce.data() + kHNonceSize, kNonceSize - 4);
+  fillState(state, subkey, counter, shortNonce);
+}
+
+/**
+ * @brief Generador de keystream escalar: un bloque detrás de otro.
+ *
+ * @param state Estado de 16 palabras; state[12] es el contador del primer bloque
+ * @param keystream Buffer de blocks * kBlockSize bytes
+ * @param blocks
+ */
+template <int kRounds>
+void chachaKeystreamScalar(const uint32_t* state, uint8_t* keystream, size_t blocks) {
+  uint32_t block[16];
+  for (int i = 0; i < 16; ++i) block[i] = state[i];
+  for (size_t b = 0; b < blocks; ++b, ++block[12]) {
+    chachaBlock<kRounds>(block, keystream + b * kBlockSize);
+  }
+}
+
+// ChaCha8, ChaCha12 y ChaCha20.
+template void chachaRounds<8>(uint32_t* state);
+template void chachaRounds<12>(uint32_t* state);
+template void chachaRounds<20>(uint32_t* state);
+template void chachaBlock<8>(const uint32_t* state, uint8_t* keystream);
+template void chachaBlock<12>(const uint32_t* state, uint8_t* keystream);
+template void chachaBlock<20>(const uint32_t* state, uint8_t* keystream);
+template void chachaKeystreamScalar<8>(const uint32_t* state, uint8_t* keystream, size_t blocks);
+template void chachaKeystreamScalar<12>(const uint32_t* state, uint8_t* keystream, size_t blocks);
+template void chachaKeystreamScalar<20>(const uint32_t* state, uint8_t* keystream, size_t blocks);
+
+namespace {
+
+// Implementaciones disponibles en esta CPU, de la más lenta a la más rápida.
+template <int kRounds>
+std::vector<KeystreamImplementation> detectImplementations() {
+  std::vector<KeystreamImplementation> list = {{"escalar", chachaKeystreamScalar<kRounds>}};
+#ifdef CHACHA20_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) {
+    list.push_back({"sse2", chachaKeystreamSse2<kRounds>});
+    if (__builtin_cpu_supports("avx2")) list.push_back({"avx2", chachaKeystreamAvx2<kRounds>});
+  }
+#endif
+  return list;
+}
+
+const KeystreamImplementation kActiveKeystream = detectImplementations<20>().back();
+const KeystreamImplementation kActiveKeystream12 = detectImplementations<12>().back();
+const KeystreamImplementation kActiveKeystream8 = detectImplementations<8>().back();
+
+}  // namespace
+
+/**
+ * @brief Generadores disponibles en esta CPU para el número de rondas dado.
+ *
+ * @param rounds
+ * @return std::vector<KeystreamImplementation>
+ * @throw std::invalid_argument Si rounds no es 8, 12 ni 20
+ */
+std::vector<KeystreamImplementation> keystreamImplementations(ChaChaRounds rounds) {
+  switch (rounds) {
+    case kChaCha8: return detectImplementations<8>();
+    case kChaCha12: return detectImplementations<12>();
+    case kChaCha20: return detectImplementations<20>();
+  }
+  throw std::invalid_argument("ChaCha solo admite 8, 12 o 20 rondas");
+}
+
+const char* activeKeystreamName() { return kActiveKeystream.name; }
+
+/**
+ * @brief Generador elegido al arrancar para el número de rondas dado.
+ *
+ * @param rounds
+ * @return KeystreamFunction
+ * @throw std::invalid_argument Si rounds no es 8, 12 ni 20
+ */
+KeystreamFunction activeKeystream(ChaChaRounds rounds) {
+  switch (rounds) {
+    case kChaCha8: return kActiveKeystream8.function;
+    case kChaCha12: return kActiveKeystream12.function;
+    case kChaCha20: return kActiveKeystream.function;
+  }
+  throw std::invalid_argument("ChaCha solo admite 8, 12 o 20 rondas");
+}
+
+/**
+ * @brief Genera bloques consecutivos de keystream con la implementación elegida al arrancar.
+ *
+ * El contador de cada bloque es state[12] más su índice, módulo 2^32; quien
+ * llama debe evitar que dé la vuelta.
+ *
+ * @param state Estado de 16 palabras
+ * @param keystream Buffer de blocks * kBlockSize bytes
+ * @param blocks
+ */
+void chacha20Keystream(const uint32_t* state, uint8_t* keystream, size_t blocks) {
+  kActiveKeystream.function(state, keystream, blocks);
+}
+
+/**
+ * @brief HChaCha20: deriva una subclave de 256 bits a partir de clave y nonce de 16 bytes.
+ *
+ * El estado se inicializa como en ChaCha20, con los 16 bytes del nonce en las
+ * palabras 12 a 15 (los 4 primeros hacen de contador). Tras las 20
+ * iteraciones, sin sumar el estado inicial, la subclave son las palabras 0-3
+ * y 12-15.
+ *
+ * @param key 32 bytes
+ * @param nonce 16 bytes
+ * @return std::vector<uint8_t> Subclave de 32 bytes
+ */
+std::vector<uint8_t> hchacha20(const std::vector<uint8_t>& key, const std::vector<uint8_t>& nonce) {
+  if (nonce.size() != kHNonceSize) throw std::invalid_argument("El nonce de HChaCha20 debe tener 16 bytes");
+  uint32_t words[8], subkeyWords[8];
+  loadKey(key, words);
+  hchacha20Words(words, nonce.data(), subkeyWords);
+  std::vector<uint8_t> subkey(kKeySize);
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < 4; ++j) subkey[i * 4 + j] = static_cast<uint8_t>(subkeyWords[i] >> (8 * j));
+  }
+  return subkey;
+}
+
+/**
+ * @brief Estado inicial de ChaCha20 (nonce de 12 bytes) o de XChaCha20 (24 bytes).
+ *
+ * XChaCha20 es ChaCha20 con la subclave HChaCha20(clave, nonce[0..16)) y el
+ * nonce 0x00000000 || nonce[16..24).
+ *
+ * @param key 32 bytes
+ * @param counter
+ * @param nonce 12 o 24 bytes
+ * @return std::vector<uint32_t>
+ */
+std::vector<uint32_t> initializeStreamState(const std::vector<uint8_t>& key, uint32_t counter,
+                                            const std::vector<uint8_t>& nonce) {
+  uint32_t words[8];
+  loadKey(key, words);
+  std::vector<uint32_t> state(16);
+  streamState(state.data(), words, counter, nonce);
+  return state;
+}
+
+/**
+ * @brief Igual que la anterior, pero sobre un estado ya reservado (sin memoria dinámica).
+ *
+ * @param state
+ * @param key 32 bytes
+ * @param counter
+ * @param nonce 12 o 24 bytes
+ */
+void initializeStreamState(ChaCha20State& state, std::span<const uint8_t> key, uint32_t counter,
+                           std::span<const uint8_t> nonce) {
+  uint32_t words[8];
+  loadKey(key, words);
+  streamState(state.data(), words, counter, nonce);
+}
+
+/**
+ * @brief Función que imprime el estado de ChaCha20.
+ *
+ * @param text
+ * @param state
+ */
+void printState(const std::string& text, const std::vector<uint32_t>& state) {
+  printState(text.c_str(), state.data());
+}
+
+/**
+ * @brief Imprime un estado de 16 palabras; sirve también como gancho de depuración (TraceFunction).
+ *
+ * @param text
+ * @param state
+ */
+void printState(const char* text, const uint32_t* state) {
+  std::cout << text << "=" << std::endl;
+  const size_t num = 4;
+
+  // Imprimir el estado en bloques de 4 palabras.
+  for (size_t i = 0; i < 16; ++i) {
+    if (i % num == 0 && i != 0) {
+      std::cout << std::endl;
+    }
+    // Imprimir en hexadecimal, rellenando con ceros los 8 dígitos.
+    std::cout << std::hex << std::setfill('0') << std::setw(8) << state[i] << " ";
+  }
+  std::cout << std::dec << std::endl << std::endl;
+}
+
+/**
+ * @brief Función que cifra un mensaje usando ChaCha20.
+ *
+ * Cada bloque de 64 bytes del mensaje usa su propio bloque de keystream, con
+ * el contador incrementado en uno respecto al anterior.
+ *
+ * @param plaintext
+ * @param key
+ * @param counter Contador del primer bloque
+ * @param nonce 12 bytes (ChaCha20) o 24 (XChaCha20)
+ * @return std::vector<uint8_t>
+ */
+std::vector<uint8_t> chacha20Encrypt(const std::vector<uint8_t>& plaintext, const std::vector<uint8_t>& key,
+                                     uint32_t counter, const std::vector<uint8_t>& nonce) {
+  std::vector<uint8_t> ciphertext(plaintext);
+  ChaCha20 cipher(key, nonce, counter);
+  cipher.xorInPlace(ciphertext);
+  return ciphertext;
+}
+
+/**
+ * @brief Constructor: prepara el estado, sin generar todavía ningún bloque.
+ *
+ * @param key 32 bytes
+ * @param nonce 12 bytes (ChaCha20) o 24 (XChaCha20)
+ * @param counter Contador del primer bloque
+ * @param rounds ChaCha20 (por defecto), ChaCha12 o ChaCha8
+ */
+ChaCha20::ChaCha20(std::span<const uint8_t> key, std::span<const uint8_t> nonce, uint32_t counter,
+                   ChaChaRounds rounds)
+    : generator_(activeKeystream(rounds)), rounds_(rounds), trace_(nullptr) {
+  loadKey(key, key_.data());
+  reset(nonce, counter);
+}
+
+/**
+ * @brief Prepara el contexto para otro mensaje con la misma clave.
+ *
+ * No reserva memoria ni vuelve a leer la clave; con un nonce de 24 bytes solo
+ * se recalcula la subclave de HChaCha20.
+ *
+ * @param nonce 12 bytes (ChaCha20) o 24 (XChaCha20)
+ * @param counter Contador del primer bloque
+ */
+void ChaCha20::reset(std::span<const uint8_t> nonce, uint32_t counter) {
+  streamState(state_.data(), key_.data(), counter, nonce);
+  counter_ = counter;
+  available_ = 0;
+  used_ = 0;
+  position_ = 0;
+  remaining_ = (uint64_t(1) << 32) - counter;
+  if (trace_) trace_("Estado inicial", state_.data());
+}
+
+/**
+ * @brief Genera los siguientes kBatchBlocks bloques de keystream y avanza el contador.
+ *
+ * El contador es de 32 bits: tras el bloque 2^32 - 1 no puede dar la vuelta
+ * sin repetir keystream, así que se generan solo los bloques que quedan y
+ * después se lanza una excepción.
+ */
+void ChaCha20::refill() {
+  if (remaining_ == 0) throw std::overflow_error("Se ha agotado el contador de bloques de ChaCha20");
+  const size_t blocks = static_cast<size_t>(std::min<uint64_t>(kBatchBlocks, remaining_));
+  if (trace_) trace_("Estado de la tanda", state_.data());
+  generator_(state_.data(), keystream_, blocks);
+  state_[12] += static_cast<uint32_t>(blocks);
+  remaining_ -= blocks;
+  available_ = blocks * kBlockSize;
+  used_ = 0;
+}
+
+/**
+ * @brief Coloca el cifrador en un byte cualquiera del keystream.
+ *
+ * El bloque que contiene offset es el de contador counter_ + offset / 64; si
+ * offset no cae al principio de un bloque, se genera la tanda y se descartan
+ * los bytes anteriores. Así varios hilos pueden cifrar partes distintas de un
+ * mismo mensaje sin generar el keystream que las precede.
+ *
+ * @param offset Byte del mensaje (0 es el primero con el contador inicial)
+ */
+void ChaCha20::seek(uint64_t offset) {
+  const uint64_t total = (uint64_t(1) << 32) - counter_;
+  const uint64_t block = offset / kBlockSize;
+  if (block > total) throw std::out_of_range("La posición supera el keystream disponible");
+  state_[12] = static_cast<uint32_t>(counter_ + block);
+  remaining_ = total - block;
+  available_ = 0;
+  used_ = 0;
+  position_ = offset;
+  if (offset % kBlockSize != 0) {
+    refill();
+    used_ = offset % kBlockSize;
+  }
+}
+
+/**
+ * @brief Cifra (o descifra) los datos en el sitio.
+ *
+ * @param data
+ */
+void ChaCha20::xorInPlace(std::span<uint8_t> data) {
+  process(data.data(), data.data(), data.size());
+}
+
+/**
+ * @brief Cifra (o descifra) input en output, sin copias intermedias.
+ *
+ * @param input
+ * @param output Al menos tan grande como input
+ */
+void ChaCha20::xorTo(std::span<const uint8_t> input, std::span<uint8_t> output) {
+  if (output.size() < input.size()) throw std::invalid_argument("La salida es más pequeña que la entrada");
+  process(input.data(), output.data(), input.size());
+}
+
+/**
+ * @brief Cifra (o descifra) los datos en el sitio.
+ *
+ * @param data
+ * @param length
+ */
+void ChaCha20::process(uint8_t* data, size_t length) {
+  process(data, data, length);
+}
+
+/**
+ * @brief Combina la entrada con el keystream y deja el resultado en output.
+ *
+ * Primero se gasta lo que quedaba de la tanda anterior; después se genera una
+ * tanda de kBatchBlocks bloques cada vez que se acaba. input y output pueden
+ * ser el mismo buffer.
+ *
+ * @param input
+ * @param output
+ * @param length
+ */
+void ChaCha20::process(const uint8_t* input, uint8_t* output, size_t length) {
+  size_t done = 0;
+  while (done < length) {
+    if (used_ == available_) refill();
+    const size_t take = std::min(available_ - used_, length - done);
+    const uint8_t* keystream = keystream_ + used_;
+    size_t i = 0;
+    // De 8 en 8 bytes; memcpy evita accesos desalineados.
+    for (; i + 8 <= take; i += 8) {
+      uint64_t data, key;
+      std::memcpy(&data, input + done + i, 8);
+      std::memcpy(&key, keystream + i, 8);
+      data ^= key;
+      std::memcpy(output + done + i, &data, 8);
+    }
+    for (; i < take; ++i) output[done + i] = input[done + i] ^ keystream[i];
+    used_ += take;
+    done += take;
+  }
+  position_ += length;
+}
@@ -0,0 +1,275 @@
+#include "../include/chacha20_simd.h"
+
+#ifdef CHACHA20_X86
+
+#include <cstring>
+#include <immintrin.h>
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// SSE2: 4 bloques. x[i] contiene la palabra i de los 4 bloques (estado
+// transpuesto), así que cada cuarto de ronda opera sobre 4 columnas a la vez
+// y las diagonales no necesitan reordenar nada.
+// ---------------------------------------------------------------------------
+
+template <int kShift>
+__attribute__((target("sse2"))) inline __m128i rotlSse2(__m128i v) {
+  return _mm_or_si128(_mm_slli_epi32(v, kShift), _mm_srli_epi32(v, 32 - kShift));
+}
+
+// Rotar 16 bits es intercambiar las dos mitades de 16 bits de cada palabra.
+template <>
+__attribute__((target("sse2"))) inline __m128i rotlSse2<16>(__m128i v) {
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1);
+}
+
+__attribute__((target("sse2"))) inline void quarterRoundSse2(__m128i& a, __m128i& b, __m128i& c, __m128i& d) {
+  a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = rotlSse2<16>(d);
+  c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = rotlSse2<12>(b);
+  a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = rotlSse2<8>(d);
+  c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = rotlSse2<7>(b);
+}
+
+/**
+ * @brief Transpone 4 palabras consecutivas de 4 bloques y las guarda en su sitio.
+ *
+ * a, b, c, d son las palabras w..w+3 (un bloque por carril); tras transponer,
+ * cada registro tiene las 4 palabras de un bloque.
+ */
+__attribute__((target("sse2"))) inline void storeTransposedSse2(__m128i a, __m128i b, __m128i c, __m128i d,
+                                                                uint8_t* out) {
+  const __m128i ab_low = _mm_unpacklo_epi32(a, b), cd_low = _mm_unpacklo_epi32(c, d);
+  const __m128i ab_high = _mm_unpackhi_epi32(a, b), cd_high = _mm_unpackhi_epi32(c, d);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0 * 64), _mm_unpacklo_epi64(ab_low, cd_low));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 1 * 64), _mm_unpackhi_epi64(ab_low, cd_low));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * 64), _mm_unpacklo_epi64(ab_high, cd_high));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 3 * 64), _mm_unpackhi_epi64(ab_high, cd_high));
+}
+
+/**
+ * @brief 4 bloques de keystream (256 bytes) a partir de 4 estados ya transpuestos.
+ *
+ * Las kRounds / 2 rondas dobles se desenrollan por completo.
+ *
+ * @param input input[i] es la palabra i de los 4 estados
+ * @param keystream
+ */
+template <int kRounds>
+__attribute__((target("sse2"))) void blocks4Sse2(const __m128i* input, uint8_t* keystream) {
+  __m128i x[16];
+#pragma GCC unroll 16
+  for (int i = 0; i < 16; ++i) x[i] = input[i];
+
+#pragma GCC unroll 10
+  for (int i = 0; i < kRounds / 2; ++i) {
+    quarterRoundSse2(x[0], x[4], x[8], x[12]);
+    quarterRoundSse2(x[1], x[5], x[9], x[13]);
+    quarterRoundSse2(x[2], x[6], x[10], x[14]);
+    quarterRoundSse2(x[3], x[7], x[11], x[15]);
+    quarterRoundSse2(x[0], x[5], x[10], x[15]);
+    quarterRoundSse2(x[1], x[6], x[11], x[12]);
+    quarterRoundSse2(x[2], x[7], x[8], x[13]);
+    quarterRoundSse2(x[3], x[4], x[9], x[14]);
+  }
+
+#pragma GCC unroll 16
+  for (int i = 0; i < 16; ++i) x[i] = _mm_add_epi32(x[i], input[i]);
+#pragma GCC unroll 4
+  for (int w = 0; w < 16; w += 4) storeTransposedSse2(x[w], x[w + 1], x[w + 2], x[w + 3], keystream + w * 4);
+}
+
+/**
+ * @brief 4 bloques de keystream (256 bytes), contadores state[12]..state[12] + 3.
+ */
+template <int kRounds>
+__attribute__((target("sse2"))) void blocks4Sse2(const uint32_t* state, uint8_t* keystream) {
+  __m128i input[16];
+#pragma GCC unroll 16
+  for (int i = 0; i < 16; ++i) input[i] = _mm_set1_epi32(static_cast<int>(state[i]));
+  input[12] = _mm_add_epi32(input[12], _mm_set_epi32(3, 2, 1, 0));
+  blocks4Sse2<kRounds>(input, keystream);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2: 8 bloques, con la misma disposición. Las rotaciones de 16 y 8 bits
+// son un único vpshufb.
+// ---------------------------------------------------------------------------
+
+template <int kShift>
+__attribute__((target("avx2"))) inline __m256i rotlAvx2(__m256i v) {
+  return _mm256_or_si256(_mm256_slli_epi32(v, kShift), _mm256_srli_epi32(v, 32 - kShift));
+}
+
+template <>
+__attribute__((target("avx2"))) inline __m256i rotlAvx2<16>(__m256i v) {
+  const __m256i mask = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                        2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+  return _mm256_shuffle_epi8(v, mask);
+}
+
+template <>
+__attribute__((target("avx2"))) inline __m256i rotlAvx2<8>(__m256i v) {
+  const __m256i mask = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                        3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+  return _mm256_shuffle_epi8(v, mask);
+}
+
+__attribute__((target("avx2"))) inline void quarterRoundAvx2(__m256i& a, __m256i& b, __m256i& c, __m256i& d) {
+  a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = rotlAvx2<16>(d);
+  c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = rotlAvx2<12>(b);
+  a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = rotlAvx2<8>(d);
+  c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = rotlAvx2<7>(b);
+}
+
+/**
+ * @brief Transpone 4 palabras de 8 bloques dentro de cada mitad de 128 bits.
+ *
+ * Tras la llamada, t[j] tiene en la mitad baja las palabras del bloque j y en
+ * la alta las del bloque j + 4.
+ */
+__attribute__((target("avx2"))) inline void transposeAvx2(__m256i a, __m256i b, __m256i c, __m256i d,
+                                                          __m256i* t) {
+  const __m256i ab_low = _mm256_unpacklo_epi32(a, b), cd_low = _mm256_unpacklo_epi32(c, d);
+  const __m256i ab_high = _mm256_unpackhi_epi32(a, b), cd_high = _mm256_unpackhi_epi32(c, d);
+  t[0] = _mm256_unpacklo_epi64(ab_low, cd_low);
+  t[1] = _mm256_unpackhi_epi64(ab_low, cd_low);
+  t[2] = _mm256_unpacklo_epi64(ab_high, cd_high);
+  t[3] = _mm256_unpackhi_epi64(ab_high, cd_high);
+}
+
+/**
+ * @brief 8 bloques de keystream (512 bytes) a partir de 8 estados ya transpuestos.
+ *
+ * @param input input[i] es la palabra i de los 8 estados
+ * @param keystream
+ */
+template <int kRounds>
+__attribute__((target("avx2"))) void blocks8Avx2(const __m256i* input, uint8_t* keystream) {
+  __m256i x[16];
+#pragma GCC unroll 16
+  for (int i = 0; i < 16; ++i) x[i] = input[i];
+
+#pragma GCC unroll 10
+  for (int i = 0; i < kRounds / 2; ++i) {
+    quarterRoundAvx2(x[0], x[4], x[8], x[12]);
+    quarterRoundAvx2(x[1], x[5], x[9], x[13]);
+    quarterRoundAvx2(x[2], x[6], x[10], x[14]);
+    quarterRoundAvx2(x[3], x[7], x[11], x[15]);
+    quarterRoundAvx2(x[0], x[5], x[10], x[15]);
+    quarterRoundAvx2(x[1], x[6], x[11], x[12]);
+    quarterRoundAvx2(x[2], x[7], x[8], x[13]);
+    quarterRoundAvx2(x[3], x[4], x[9], x[14]);
+  }
+
+#pragma GCC unroll 16
+  for (int i = 0; i < 16; ++i) x[i] = _mm256_add_epi32(x[i], input[i]);
+
+  // Palabras 0-3, 4-7, 8-11 y 12-15 de cada bloque; se juntan las mitades
+  // bajas (bloques 0-3) y altas (bloques 4-7) de cada pareja de grupos.
+  __m256i g0[4], g1[4], g2[4], g3[4];
+  transposeAvx2(x[0], x[1], x[2], x[3], g0);
+  transposeAvx2(x[4], x[5], x[6], x[7], g1);
+  transposeAvx2(x[8], x[9], x[10], x[11], g2);
+  transposeAvx2(x[12], x[13], x[14], x[15], g3);
+#pragma GCC unroll 4
+  for (int j = 0; j < 4; ++j) {
+    uint8_t* low = keystream + j * 64;
+    uint8_t* high = keystream + (j + 4) * 64;
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(low), _mm256_permute2x128_si256(g0[j], g1[j], 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(low + 32), _mm256_permute2x128_si256(g2[j], g3[j], 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(high), _mm256_permute2x128_si256(g0[j], g1[j], 0x31));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(high + 32), _mm256_permute2x128_si256(g2[j], g3[j], 0x31));
+  }
+}
+
+/**
+ * @brief 8 bloques de keystream (512 bytes), contadores state[12]..state[12] + 7.
+ */
+template <int kRounds>
+__attribute__((target("avx2"))) void blocks8Avx2(const uint32_t* state, uint8_t* keystream) {
+  __m256i input[16];
+#pragma GCC unroll 16
+  for (int i = 0; i < 16; ++i) input[i] = _mm256_set1_epi32(static_cast<int>(state[i]));
+  input[12] = _mm256_add_epi32(input[12], _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+  blocks8Avx2<kRounds>(input, keystream);
+}
+
+}  // namespace
+
+/**
+ * @brief Generador SSE2 de ChaCha con kRounds rondas: tandas de 4 bloques.
+ *
+ * Si el número de bloques no es múltiplo de 4, la última tanda se calcula en
+ * un buffer aparte y se copia solo lo pedido.
+ *
+ * @param state Estado de 16 palabras; state[12] es el contador del primer bloque
+ * @param keystream Buffer de blocks * 64 bytes
+ * @param blocks
+ */
+template <int kRounds>
+__attribute__((target("sse2"))) void chachaKeystreamSse2(const uint32_t* state, uint8_t* keystream, size_t blocks) {
+  uint32_t local[16];
+  std::memcpy(local, state, sizeof(local));
+  for (; blocks >= 4; blocks -= 4, keystream += 4 * 64, local[12] += 4) blocks4Sse2<kRounds>(local, keystream);
+  if (blocks > 0) {
+    alignas(16) uint8_t tail[4 * 64];
+    blocks4Sse2<kRounds>(local, tail);
+    std::memcpy(keystream, tail, blocks * 64);
+  }
+}
+
+/**
+ * @brief Generador AVX2 de ChaCha con kRounds rondas: tandas de 8 bloques; el resto, con SSE2.
+ *
+ * @param state Estado de 16 palabras; state[12] es el contador del primer bloque
+ * @param keystream Buffer de blocks * 64 bytes
+ * @param blocks
+ */
+template <int kRounds>
+__attribute__((target("avx2"))) void chachaKeystreamAvx2(const uint32_t* state, uint8_t* keystream, size_t blocks) {
+  uint32_t local[16];
+  std::memcpy(local, state, sizeof(local));
+  for (; blocks >= 8; blocks -= 8, keystream += 8 * 64, local[12] += 8) blocks8Avx2<kRounds>(local, keystream);
+  if (blocks > 0) chachaKeystreamSse2<kRounds>(local, keystream, blocks);
+}
+
+// ChaCha8, ChaCha12 y ChaCha20.
+template void chachaKeystreamSse2<8>(const uint32_t* state, uint8_t* keystream, size_t blocks);
+template void chachaKeystreamSse2<12>(const uint32_t* state, uint8_t* keystream, size_t blocks);
+template void chachaKeystreamSse2<20>(const uint32_t* state, uint8_t* keystream, size_t blocks);
+template void chachaKeystreamAvx2<8>(const uint32_t* state, uint8_t* keystream, size_t blocks);
+template void chachaKeystreamAvx2<12>(const uint32_t* state, uint8_t* keystream, size_t blocks);
+template void chachaKeystreamAvx2<20>(const uint32_t* state, uint8_t* keystream, size_t blocks);
+
+/**
+ * @brief Un bloque de cada uno de kLanes estados independientes, con SSE2 (dos tandas de 4).
+ *
+ * @param lanes lanes[w * kLanes + l] es la palabra w del estado del carril l
+ * @param keystream Buffer de kLanes * 64 bytes; el bloque del carril l empieza en l * 64
+ */
+__attribute__((target("sse2"))) void chacha20LanesSse2(const uint32_t* lanes, uint8_t* keystream) {
+  for (size_t half = 0; half < kLanes; half += 4) {
+    __m128i input[16];
+#pragma GCC unroll 16
+    for (int i = 0; i < 16; ++i) {
+      input[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + i * kLanes + half));
+    }
+    blocks4Sse2<20>(input, keystream + half * 64);
+  }
+}
+
+/**
+ * @brief Un bloque de cada uno de kLanes estados independientes, con AVX2 (un carril por mensaje).
+ *
+ * @param lanes lanes[w * kLanes + l] es la palabra w del estado del carril l
+ * @param keystream Buffer de kLanes * 64 bytes; el bloque del carril l empieza en l * 64
+ */
+__attribute__((target("avx2"))) void chacha20LanesAvx2(const uint32_t* lanes, uint8_t* keystream) {
+  __m256i input[16];
+#pragma GCC unroll 16
+  for (int i = 0; i < 16; ++i) input[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes + i * kLanes));
+  blocks8Avx2<20>(input, keystream);
+}
+
+#endif  // CHACHA20_X86
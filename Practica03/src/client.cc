@@ -0,0 +1,536 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../include/aead.h"
+#include "../include/chacha20.h"
+#include "../include/csprng.h"
+#include "../include/flujo.h"
+#include "../include/lotes.h"
+#include "../include/mapeo.h"
+#include "../include/paralelo.h"
+#include "../include/tuberia.h"
+
+/**
+ * @brief Muestra la forma de uso del programa.
+ *
+ * @param program
+ */
+void showUsage(const char* program) {
+  std::cerr << "Uso:" << std::endl;
+  std::cerr << "  " << program << "                        (ejemplo del RFC 8439 con nonce aleatorio)" << std::endl;
+  std::cerr << "  " << program << " --flujo <clave> <nonce> <contador> [entrada] [salida]" << std::endl;
+  std::cerr << "      clave: 64 dígitos hex, nonce: 24 dígitos hex (48 para XChaCha20)" << std::endl;
+  std::cerr << "      entrada y salida: por defecto stdin/stdout, '-' también" << std::endl;
+  std::cerr << "  " << program << " --paralelo <hilos> <clave> <nonce> <contador> <entrada> <salida>"
+            << "  (0 hilos = todos los núcleos)" << std::endl;
+  std::cerr << "  " << program << " --tuberia <hilos> <clave> <nonce> <contador> <entrada> <salida>"
+            << "  (lectura, cifrado y escritura solapados)" << std::endl;
+  std::cerr << "  " << program << " --rango <clave> <nonce> <contador> <desplazamiento> <longitud> <entrada> [salida]"
+            << std::endl;
+  std::cerr << "      descifra solo esos bytes del fichero cifrado (salida por defecto stdout)" << std::endl;
+  std::cerr << "  " << program << " --sellar <clave> <nonce> [entrada] [salida]  (ChaCha20-Poly1305, etiqueta al final)"
+            << std::endl;
+  std::cerr << "  " << program << " --abrir <clave> <nonce> [entrada] [salida]" << std::endl;
+  std::cerr << "  " << program << " --prueba-rfc             (vectores de prueba del RFC 8439)" << std::endl;
+}
+
+/**
+ * @brief Convierte una cadena hexadecimal en bytes.
+ *
+ * @param text
+ * @param size Número de bytes esperado
+ * @return std::vector<uint8_t>
+ */
+std::vector<uint8_t> parseHex(const std::string& text, size_t size) {
+  if (text.size() != size * 2) {
+    throw std::invalid_argument("Se esperaban " + std::to_string(size * 2) + " dígitos hexadecimales: " + text);
+  }
+  std::vector<uint8_t> bytes(size);
+  for (size_t i = 0; i < size; ++i) {
+    size_t read = 0;
+    const std::string pair = text.substr(i * 2, 2);
+    const unsigned long value = std::stoul(pair, &read, 16);
+    if (read != 2) throw std::invalid_argument("Dígito hexadecimal no válido: " + pair);
+    bytes[i] = static_cast<uint8_t>(value);
+  }
+  return bytes;
+}
+
+/**
+ * @brief Lee un nonce de 12 bytes (ChaCha20) o de 24 (XChaCha20).
+ *
+ * @param text 24 o 48 dígitos hexadecimales
+ * @return std::vector<uint8_t>
+ */
+std::vector<uint8_t> parseNonce(const std::string& text) {
+  return parseHex(text, text.size() == kXNonceSize * 2 ? kXNonceSize : kNonceSize);
+}
+
+/**
+ * @brief Lee el contador inicial de 32 bits.
+ *
+ * @param text
+ * @return uint32_t
+ */
+uint32_t parseCounter(const std::string& text) {
+  const unsigned long counter = std::stoul(text);
+  if (counter > UINT32_MAX) throw std::invalid_argument("El contador es de 32 bits");
+  return static_cast<uint32_t>(counter);
+}
+
+/**
+ * @brief Imprime bytes en hexadecimal.
+ *
+ * @param bytes
+ */
+void printHex(const std::vector<uint8_t>& bytes) {
+  for (const uint8_t& b : bytes) {
+    std::cout << std::hex << std::setfill('0') << std::setw(2) << static_cast<int>(b);
+  }
+  std::cout << std::dec;
+}
+
+/**
+ * @brief Abre un fichero del modo flujo; "-" o ausente indica la entrada/salida estándar.
+ *
+ * La salida se trunca solo después de comprobar que no es el fichero de
+ * entrada: si lo fuera, se vaciaría antes de leerlo (o, si está proyectado,
+ * se terminaría con SIGBUS).
+ *
+ * @param path
+ * @param writing
+ * @param input Descriptor de entrada ya abierto (al abrir la salida), o -1
+ * @param mappedInput Entrada proyectada en memoria, o nullptr
+ * @return int Descriptor
+ */
+int openDescriptor(const char* path, bool writing, int input = -1, const ArchivoMapeado* mappedInput = nullptr) {
+  if (path == nullptr || std::string(path) == "-") return writing ? STDOUT_FILENO : STDIN_FILENO;
+  int fd = writing ? open(path, O_WRONLY | O_CREAT, 0644) : open(path, O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error(std::string("No se puede abrir ") + path + ": " + std::strerror(errno));
+  }
+  if (writing) {
+    if ((input >= 0 && MismoArchivo(input, fd)) || (mappedInput != nullptr && mappedInput->MismoArchivo(fd))) {
+      close(fd);
+      throw std::invalid_argument("La entrada y la salida son el mismo fichero");
+    }
+    if (ftruncate(fd, 0) < 0) {
+      int error = errno;
+      close(fd);
+      throw std::runtime_error(std::string("No se puede truncar ") + path + ": " + std::strerror(error));
+    }
+  }
+  return fd;
+}
+
+/**
+ * @brief Cierra los descriptores del modo flujo que no sean los estándar.
+ *
+ * @param input
+ * @param output
+ */
+void closeDescriptors(int input, int output) {
+  if (input != STDIN_FILENO) close(input);
+  if (output != STDOUT_FILENO && close(output) < 0) {
+    throw std::runtime_error(std::string("Error al cerrar la salida: ") + std::strerror(errno));
+  }
+}
+
+/**
+ * @brief Modo flujo: cifra la entrada por trozos, con memoria constante.
+ *
+ * El mismo comando, con la misma clave, nonce y contador, descifra.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int streamMode(int argc, char* argv[]) {
+  if (argc < 5 || argc > 7) {
+    showUsage(argv[0]);
+    return 1;
+  }
+  ChaCha20 cipher(parseHex(argv[2], kKeySize), parseNonce(argv[3]), parseCounter(argv[4]));
+  int input = openDescriptor(argc > 5 ? argv[5] : nullptr, false);
+  int output = openDescriptor(argc > 6 ? argv[6] : nullptr, true, input);
+  size_t total = encryptStream(input, output, cipher);
+  closeDescriptors(input, output);
+  std::cerr << "Procesados " << total << " bytes" << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Modo paralelo: reparte un fichero grande entre varios hilos.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int parallelMode(int argc, char* argv[]) {
+  if (argc != 8) {
+    showUsage(argv[0]);
+    return 1;
+  }
+  const unsigned threads = static_cast<unsigned>(std::stoul(argv[2]));
+  size_t total = encryptParallel(argv[6], argv[7], parseHex(argv[3], kKeySize), parseNonce(argv[4]),
+                                 parseCounter(argv[5]), threads);
+  std::cerr << "Procesados " << total << " bytes" << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Modo tubería: lector, trabajadores y escritor en paralelo, con io_uring si está disponible.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int pipelineMode(int argc, char* argv[]) {
+  if (argc != 8) {
+    showUsage(argv[0]);
+    return 1;
+  }
+  const unsigned workers = static_cast<unsigned>(std::stoul(argv[2]));
+  size_t total = encryptPipeline(argv[6], argv[7], parseHex(argv[3], kKeySize), parseNonce(argv[4]),
+                                 parseCounter(argv[5]), workers);
+  std::cerr << "Procesados " << total << " bytes (E/S con " << (ioUringAvailable() ? "io_uring" : "pread/pwrite")
+            << ")" << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Modo rango: descifra un trozo cualquiera de un fichero cifrado sin descifrar lo anterior.
+ *
+ * @param argc
+ * @param argv
+ * @return int
+ */
+int rangeMode(int argc, char* argv[]) {
+  if (argc < 8 || argc > 9) {
+    showUsage(argv[0]);
+    return 1;
+  }
+  ChaCha20 cipher(parseHex(argv[2], kKeySize), parseNonce(argv[3]), parseCounter(argv[4]));
+  const uint64_t offset = std::stoull(argv[5]);
+  const uint64_t length = std::stoull(argv[6]);
+  // El rango se comprueba antes de abrir la salida, que se trunca al abrirla.
+  ArchivoMapeado input(argv[7]);
+  checkRange(input, offset, length);
+  int output = openDescriptor(argc > 8 ? argv[8] : nullptr, true, -1, &input);
+  size_t total;
+  try {
+    total = decryptRange(input, cipher, offset, length, output);
+  } catch (...) {
+    closeDescriptors(STDIN_FILENO, output);
+    throw;
+  }
+  closeDescriptors(STDIN_FILENO, output);
+  std::cerr << "Procesados " << total << " bytes" << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Modo autenticado: sella o abre con ChaCha20-Poly1305 por trozos.
+ *
+ * Al abrir, si la etiqueta no coincide y la salida es un fichero, se borra
+ * para no dejar texto sin autenticar.
+ *
+ * @param argc
+ * @param argv
+ * @param mode
+ * @return int
+ */
+int aeadMode(int argc, char* argv[], ChaCha20Poly1305::Mode mode) {
+  if (argc < 4 || argc > 6) {
+    showUsage(argv[0]);
+    return 1;
+  }
+  ChaCha20Poly1305 aead(parseHex(argv[2], kKeySize), parseNonce(argv[3]), mode);
+  const char* outputPath = argc > 5 ? argv[5] : nullptr;
+  int input = openDescriptor(argc > 4 ? argv[4] : nullptr, false);
+  int output = openDescriptor(outputPath, true, input);
+  size_t total;
+  try {
+    total = mode == ChaCha20Poly1305::kSeal ? sealStream(input, output, aead) : openStream(input, output, aead);
+  } catch (...) {
+    closeDescriptors(input, output);
+    if (mode == ChaCha20Poly1305::kOpen && output != STDOUT_FILENO) unlink(outputPath);
+    throw;
+  }
+  closeDescriptors(input, output);
+  std::cerr << "Procesados " << total << " bytes" << std::endl;
+  return 0;
+}
+
+/**
+ * @brief Comprueba el cifrador con los vectores de prueba del RFC 8439.
+ *
+ * - 2.3.2: un bloque de keystream (contador 1), también con el bloque del Csprng.
+ * - 2.4.2: el mensaje "sunscreen" de 114 bytes, que ocupa dos bloques.
+ * - A.2 #1: clave y nonce a cero, contador 0; también con ChaCha8 y ChaCha12
+ *   (draft-strombergson-chacha-test-vectors, TC1). Este caso se repite con
+ *   cada generador de keystream disponible (escalar, SSE2, AVX2).
+ * - 2.5.2: Poly1305; además, un mensaje de 1500 bytes de una vez (camino
+ *   vectorial) y por trozos cortos (escalar) debe dar la etiqueta de OpenSSL.
+ * - 2.8.2: ChaCha20-Poly1305, que además debe rechazar el mensaje con un bit cambiado.
+ * - draft-irtf-cfrg-xchacha, 2.2.1 y A.3.1: HChaCha20 y XChaCha20-Poly1305.
+ *
+ * El mensaje de 2.4.2 se cifra también por trozos de tamaños variados, que
+ * deben dar el mismo resultado, y recortado a varias longitudes en un mismo
+ * lote multi-buffer (con cada generador de carriles y algunos mensajes con
+ * XChaCha20).
+ *
+ * @return int 0 si todos los vectores coinciden
+ */
+int rfcMode() {
+  std::vector<uint8_t> key(kKeySize);
+  for (size_t i = 0; i < kKeySize; ++i) key[i] = static_cast<uint8_t>(i);
+  int failures = 0;
+  auto hex = [](const std::string& text) { return parseHex(text, text.size() / 2); };
+  auto check = [&](const std::string& name, const std::vector<uint8_t>& got, const std::vector<uint8_t>& expected) {
+    const bool ok = got == expected;
+    std::cout << name << ": " << (ok ? "OK" : "FALLO") << std::endl;
+    failures += !ok;
+  };
+
+  const std::vector<uint8_t> blockNonce = parseHex("000000090000004a00000000", kNonceSize);
+  const std::vector<uint8_t> blockExpected = hex("10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+                                                 "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e");
+  check("2.3.2 bloque", chacha20Encrypt(std::vector<uint8_t>(kBlockSize), key, 1, blockNonce), blockExpected);
+  std::vector<uint8_t> csprngBlock(kBlockSize);
+  Csprng::testBlock(key.data(), 1, blockNonce.data(), csprngBlock.data());
+  check("2.3.2 bloque (Csprng)", csprngBlock, blockExpected);
+
+  const std::string message = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the "
+                              "future, sunscreen would be it.";
+  const std::vector<uint8_t> plaintext(message.begin(), message.end());
+  const std::vector<uint8_t> nonce = parseHex("000000000000004a00000000", kNonceSize);
+  const std::string expected =
+      "6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b"
+      "f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8"
+      "07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+      "5af90bbf74a35be6b40b8eedf2785e42874d";
+  check("2.4.2 cifrado", chacha20Encrypt(plaintext, key, 1, nonce), hex(expected));
+
+  std::vector<uint8_t> pieces(plaintext);
+  ChaCha20 cipher(key, nonce, 1);
+  for (size_t done = 0, size = 1; done < pieces.size(); done += size, size = size * 3 + 1) {
+    cipher.process(pieces.data() + done, std::min(size, pieces.size() - done));
+  }
+  check("2.4.2 por trozos", pieces, hex(expected));
+
+  // Multi-buffer, con cada generador de carriles: el mismo mensaje recortado a
+  // longitudes distintas, un mensaje por carril. Los marcados van con XChaCha20
+  // (nonce de 24 bytes) y se comparan con el cifrador de flujo.
+  const std::vector<uint8_t> xnonce = hex("404142434445464748494a4b4c4d4e4f5051525354555657");
+  const std::vector<uint8_t> full = hex(expected);
+  std::vector<uint8_t> xfull(plaintext);
+  ChaCha20(key, xnonce, 1).xorInPlace(xfull);
+  const std::pair<size_t, bool> lengths[] = {{114, false}, {1, false},  {63, false},  {64, true},   {65, false},
+                                             {0, false},   {100, true}, {114, false}, {7, false},   {128, false},
+                                             {114, true}};
+  for (const LanesImplementation& implementation : lanesImplementations()) {
+    std::vector<std::vector<uint8_t>> messages;
+    std::vector<ChaCha20Job> jobs;
+    std::vector<uint8_t> batched, batchExpected;
+    for (const auto& entry : lengths) {
+      messages.emplace_back(plaintext.begin(), plaintext.begin() + std::min(entry.first, plaintext.size()));
+    }
+    for (size_t i = 0; i < messages.size(); ++i) {
+      jobs.push_back({key, lengths[i].second ? xnonce : nonce, 1, messages[i]});
+    }
+    chacha20Batch(jobs, implementation.function);
+    for (size_t i = 0; i < messages.size(); ++i) {
+      const std::vector<uint8_t>& reference = lengths[i].second ? xfull : full;
+      batched.insert(batched.end(), messages[i].begin(), messages[i].end());
+      batchExpected.insert(batchExpected.end(), reference.begin(), reference.begin() + messages[i].size());
+    }
+    check(std::string("2.4.2 multi-buffer, ") + implementation.name, batched, batchExpected);
+  }
+
+  // Clave, nonce y contador a cero: primer bloque con 20, 8 y 12 rondas.
+  const std::vector<uint8_t> zeroKey(kKeySize), zeroNonce(kNonceSize);
+  const std::vector<std::pair<ChaChaRounds, std::vector<uint8_t>>> zeroBlocks = {
+      {kChaCha20, hex("76b8e0ada0f13d90405d6ae55386bd28bdd219b8a08ded1aa836efcc8b770dc7"
+                      "da41597c5157488d7724e03fb8d84a376a43b8f41518a11cc387b669b2ee6586")},
+      {kChaCha8, hex("3e00ef2f895f40d67f5bb8e81f09a5a12c840ec3ce9a7f3b181be188ef711a1e"
+                     "984ce172b9216f419f445367456d5619314a42a3da86b001387bfdb80e0cfe42")},
+      {kChaCha12, hex("9bf49a6a0755f953811fce125f2683d50429c3bb49e074147e0089a52eae155f"
+                      "0564f879d27ae3c02ce82834acfa8c793a629f2ca0de6919610be82f411326be")}};
+  check("A.2 #1", chacha20Encrypt(std::vector<uint8_t>(kBlockSize), zeroKey, 0, zeroNonce), zeroBlocks[0].second);
+  std::vector<uint8_t> reduced(kBlockSize);
+  ChaCha20(zeroKey, zeroNonce, 0, kChaCha8).xorInPlace(reduced);
+  check("ChaCha8 TC1", reduced, zeroBlocks[1].second);
+  reduced.assign(kBlockSize, 0);
+  ChaCha20(zeroKey, zeroNonce, 0, kChaCha12).xorInPlace(reduced);
+  check("ChaCha12 TC1", reduced, zeroBlocks[2].second);
+
+  // Cada generador de la CPU, no solo el elegido al arrancar: con 1 a 17 bloques
+  // (impares y colas de los lotes SIMD incluidas) el primero debe ser el del
+  // vector y los demás, los del generador escalar.
+  ChaCha20State zeroState;
+  initializeStreamState(zeroState, zeroKey, 0, zeroNonce);
+  for (const auto& [rounds, block] : zeroBlocks) {
+    const std::vector<KeystreamImplementation> list = keystreamImplementations(rounds);
+    std::vector<uint8_t> reference(17 * kBlockSize);
+    list.front().function(zeroState.data(), reference.data(), 17);
+    for (const KeystreamImplementation& implementation : list) {
+      std::vector<uint8_t> got, wanted;
+      for (size_t blocks = 1; blocks <= 17; ++blocks) {
+        std::vector<uint8_t> keystream(blocks * kBlockSize);
+        implementation.function(zeroState.data(), keystream.data(), blocks);
+        got.insert(got.end(), keystream.begin(), keystream.end());
+        wanted.insert(wanted.end(), block.begin(), block.end());
+        wanted.insert(wanted.end(), reference.begin() + kBlockSize, reference.begin() + blocks * kBlockSize);
+      }
+      check("TC1 " + std::to_string(rounds) + " rondas, " + implementation.name, got, wanted);
+    }
+  }
+
+  const std::string poly_message = "Cryptographic Forum Research Group";
+  const std::vector<uint8_t> poly_key =
+      parseHex("85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b", kPoly1305KeySize);
+  Poly1305 mac(poly_key.data());
+  mac.update(reinterpret_cast<const uint8_t*>(poly_message.data()), poly_message.size());
+  std::vector<uint8_t> tag(kPoly1305TagSize);
+  mac.finish(tag.data());
+  check("2.5.2 Poly1305", tag, hex("a8061dc1305136c6c22b8baf0c0127a9"));
+
+  // Los vectores del RFC son demasiado cortos para el camino de 4 bloques
+  // (desde 16 bloques). De una vez, un mensaje largo pasa por él; en trozos
+  // de menos de 256 bytes se queda en el escalar. Las dos etiquetas deben ser
+  // la de referencia, calculada aparte con `openssl mac POLY1305`.
+  std::vector<uint8_t> long_message(1500);
+  for (size_t i = 0; i < long_message.size(); ++i) long_message[i] = static_cast<uint8_t>(i * 7 + 3);
+  Poly1305 whole(poly_key.data());
+  whole.update(long_message.data(), long_message.size());
+  std::vector<uint8_t> whole_tag(kPoly1305TagSize);
+  whole.finish(whole_tag.data());
+  Poly1305 split(poly_key.data());
+  for (size_t done = 0, size = 1; done < long_message.size(); done += size, size = size % 240 + 13) {
+    split.update(long_message.data() + done, std::min(size, long_message.size() - done));
+  }
+  std::vector<uint8_t> split_tag(kPoly1305TagSize);
+  split.finish(split_tag.data());
+  const std::vector<uint8_t> long_tag = hex("d55d33e879459acfeb5a8c004f03a930");
+  check("Poly1305 1500 bytes, escalar", split_tag, long_tag);
+  check(std::string("Poly1305 1500 bytes, ") + activePoly1305Name(), whole_tag, long_tag);
+
+  std::vector<uint8_t> aead_key(kKeySize);
+  for (size_t i = 0; i < kKeySize; ++i) aead_key[i] = static_cast<uint8_t>(0x80 + i);
+  const std::vector<uint8_t> aead_nonce = parseHex("070000004041424344454647", kNonceSize);
+  const std::vector<uint8_t> aad = parseHex("50515253c0c1c2c3c4c5c6c7", 12);
+  const std::vector<uint8_t> sealed = aeadSeal(aead_key, aead_nonce, plaintext, aad);
+  check("2.8.2 sellado", sealed,
+        hex("d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b"
+            "1a71de0a9e060b2905d6a5b67ecd3b3692ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+            "3ff4def08e4b7a9de576d26586cec64b6116"
+            "1ae10b594f09e26a7e902ecbd0600691"));
+  check("2.8.2 abierto", aeadOpen(aead_key, aead_nonce, sealed, aad), plaintext);
+  std::vector<uint8_t> tampered(sealed);
+  tampered[7] ^= 0x01;
+  bool rejected = false;
+  try {
+    aeadOpen(aead_key, aead_nonce, tampered, aad);
+  } catch (const std::runtime_error&) {
+    rejected = true;
+  }
+  std::cout << "2.8.2 modificado: " << (rejected ? "OK" : "FALLO") << std::endl;
+  failures += !rejected;
+
+  check("HChaCha20", hchacha20(key, hex("000000090000004a0000000031415927")),
+        hex("82413b4227b27bfed30e42508a877d73a0f9e4d58a74a853c12ec41326d3ecdc"));
+  check("XChaCha20-Poly1305", aeadSeal(aead_key, xnonce, plaintext, aad),
+        hex("bd6d179d3e83d43b9576579493c0e939572a1700252bfaccbed2902c21396cbb731c7f1b0b4aa6440bf3a82f4eda7e39"
+            "ae64c6708c54c216cb96b72e1213b4522f8c9ba40db5d945b11b69b982c1bb9e3f3fac2bc369488f76b2383565d3fff9"
+            "21f9664c97637da9768812f615c68b13b52e"
+            "c0875924c1c7987947deafd8780acf49"));
+  return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Ejemplo del RFC 8439 (sección 2.4.2) con un nonce aleatorio.
+ *
+ * Muestra los estados del primer bloque, el cifrado y el descifrado.
+ *
+ * @return int
+ */
+int demoMode() {
+  // Inicializamos la clave de 256 bits en forma de 8 palabras en hexadecimal.
+  std::vector<uint8_t> key = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+  };
+
+  // Inicializamos un contador de 32 bits en forma de 1 palabra en hexadecimal.
+  uint32_t counter = 0x00000001;
+
+  // Inicializamos un nonce aleatorio de 96 bits en forma de 3 palabras en hexadecimal.
+  std::vector<uint8_t> nonce = generateRandomNonce();
+
+  std::cout << "Nonce generado: ";
+  printHex(nonce);
+  std::cout << std::endl << std::endl;
+
+  // Estados del primer bloque: inicial, tras las 20 iteraciones y de salida.
+  auto state = initializeState(key, counter, nonce);
+  printState("Estado inicial", state);
+  auto originalState = state;
+  chacha20Rounds(state);
+  printState("Estado final tras las 20 iteraciones", state);
+  for (int i = 0; i < 16; ++i) {
+    state[i] += originalState[i];
+  }
+  printState("Estado de salida del generador", state);
+
+  // Inicializamos el mensaje a cifrar.
+  std::string message = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it";
+  // Convertimos el mensaje a un vector de 8 bytes.
+  std::vector<uint8_t> plaintext(message.begin(), message.end());
+
+  // Realizamos el cifrado y mostramos el resultado en hexadecimal.
+  auto ciphertext = chacha20Encrypt(plaintext, key, counter, nonce);
+  std::cout << "Cifrado: ";
+  printHex(ciphertext);
+  std::cout << std::endl << std::endl;
+
+  // Realizamos el descifrado y mostramos el resultado en texto plano.
+  auto decrypted = chacha20Encrypt(ciphertext, key, counter, nonce);
+  // Convertimos el vector de bytes a string.
+  std::string decryptedStr(decrypted.begin(), decrypted.end());
+  std::cout << "Descifrado: " << decryptedStr << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
+
+int main(int argc, char* argv[]) {
+  try {
+    if (argc == 1) return demoMode();
+    std::string mode = argv[1];
+    if (mode == "--flujo") return streamMode(argc, argv);
+    if (mode == "--paralelo") return parallelMode(argc, argv);
+    if (mode == "--tuberia") return pipelineMode(argc, argv);
+    if (mode == "--rango") return rangeMode(argc, argv);
+    if (mode == "--sellar") return aeadMode(argc, argv, ChaCha20Poly1305::kSeal);
+    if (mode == "--abrir") return aeadMode(argc, argv, ChaCha20Poly1305::kOpen);
+    if (mode == "--prueba-rfc") return rfcMode();
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  showUsage(argv[0]);
+  return 1;
+}
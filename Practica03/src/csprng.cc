@@ -0,0 +1,147 @@
+#include "../include/csprng.h"
+#include "../include/chacha20.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <string.h>
+#include <sys/random.h>
+
+// Bloques que se generan con una misma clave cuando la salida va directa al destino.
+static const size_t kCsprngMaxBlocks = size_t(1) << 16;
+static const uint32_t kZeroNonce[3] = {0, 0, 0};
+
+static uint32_t loadWord(const uint8_t* bytes) {
+  return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+         (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+/**
+ * @brief Bloque de ChaCha20 (RFC 8439) con la clave, el contador y el nonce dados.
+ *
+ * Usa el mismo bloque escalar que el cifrador. El generador siempre pasa
+ * nonce cero; el nonce está para poder comprobarlo con los vectores del RFC.
+ */
+static void block(const uint32_t* key, uint32_t counter, const uint32_t* nonce, uint8_t* output) {
+  uint32_t state[16];
+  std::copy(kConstants.begin(), kConstants.end(), state);
+  std::memcpy(state + 4, key, 32);
+  state[12] = counter;
+  std::memcpy(state + 13, nonce, 12);
+  chachaBlock<20>(state, output);
+  explicit_bzero(state, sizeof(state));
+}
+
+/**
+ * @brief Crea el generador con una clave de getrandom().
+ *
+ * @throw std::runtime_error Si el sistema no puede dar bytes aleatorios
+ */
+Csprng::Csprng() : used_(sizeof(buffer_)) {
+  uint8_t* seed = reinterpret_cast<uint8_t*>(key_);
+  for (size_t got = 0; got < sizeof(key_);) {
+    ssize_t n = getrandom(seed + got, sizeof(key_) - got, 0);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("No se puede obtener la semilla: ") + std::strerror(errno));
+    }
+    got += static_cast<size_t>(n);
+  }
+}
+
+Csprng::~Csprng() {
+  explicit_bzero(key_, sizeof(key_));
+  explicit_bzero(buffer_, sizeof(buffer_));
+}
+
+Csprng& Csprng::threadLocal() {
+  static thread_local Csprng generator;
+  return generator;
+}
+
+/**
+ * @brief Escribe `blocks` bloques de keystream en output y cambia la clave.
+ *
+ * La salida usa los contadores 1..blocks y la clave nueva sale del bloque 0,
+ * así que nunca coincide con bytes entregados.
+ */
+void Csprng::generate(uint8_t* output, size_t blocks) {
+  for (size_t i = 0; i < blocks; ++i) block(key_, static_cast<uint32_t>(i + 1), kZeroNonce, output + 64 * i);
+  uint8_t next[64];
+  block(key_, 0, kZeroNonce, next);
+  std::memcpy(key_, next, sizeof(key_));
+  explicit_bzero(next, sizeof(next));
+}
+
+/**
+ * @brief Bloque del generador con clave y nonce arbitrarios, para comprobarlo con vectores conocidos.
+ *
+ * @param key 32 bytes
+ * @param counter
+ * @param nonce 12 bytes
+ * @param output 64 bytes
+ */
+void Csprng::testBlock(const uint8_t* key, uint32_t counter, const uint8_t* nonce, uint8_t* output) {
+  uint32_t keyWords[8], nonceWords[3];
+  for (int i = 0; i < 8; ++i) keyWords[i] = loadWord(key + 4 * i);
+  for (int i = 0; i < 3; ++i) nonceWords[i] = loadWord(nonce + 4 * i);
+  block(keyWords, counter, nonceWords, output);
+  explicit_bzero(keyWords, sizeof(keyWords));
+}
+
+void Csprng::refill() {
+  generate(buffer_, kCsprngBlocks);
+  used_ = 0;
+}
+
+/**
+ * @brief Rellena output con bytes aleatorios.
+ *
+ * Primero se gasta lo que queda en el buffer; los bloques completos de una
+ * petición grande se generan directamente en output, sin pasar por él.
+ */
+void Csprng::fill(uint8_t* output, size_t length) {
+  size_t take = std::min(length, sizeof(buffer_) - used_);
+  std::memcpy(output, buffer_ + used_, take);
+  explicit_bzero(buffer_ + used_, take);
+  used_ += take;
+  output += take;
+  length -= take;
+
+  while (length >= sizeof(buffer_)) {
+    size_t blocks = std::min(length / 64, kCsprngMaxBlocks);
+    generate(output, blocks);
+    output += 64 * blocks;
+    length -= 64 * blocks;
+  }
+
+  if (length > 0) {
+    refill();
+    std::memcpy(output, buffer_, length);
+    explicit_bzero(buffer_, length);
+    used_ = length;
+  }
+}
+
+void Csprng::fill(std::span<uint8_t> output) { fill(output.data(), output.size()); }
+
+/**
+ * @brief Entero uniforme en [0, bound) por rechazo.
+ *
+ * Se descartan los valores por debajo de 2^64 mod bound, de modo que los que
+ * quedan son un múltiplo exacto de bound.
+ *
+ * @throw std::invalid_argument Si bound es 0
+ */
+uint64_t Csprng::uniform(uint64_t bound) {
+  if (bound == 0) throw std::invalid_argument("El rango del número aleatorio no puede estar vacío");
+  const uint64_t threshold = (0 - bound) % bound;
+  uint64_t value;
+  do {
+    fill(reinterpret_cast<uint8_t*>(&value), sizeof(value));
+  } while (value < threshold);
+  return value % bound;
+}
@@ -0,0 +1,196 @@
+#include "../include/flujo.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Lee hasta llenar el buffer o llegar al final de la entrada.
+ *
+ * Una tubería puede devolver lecturas parciales; se insiste para que todos los
+ * trozos salvo el último tengan el tamaño completo.
+ *
+ * @return size_t Bytes leídos (0 al final de la entrada)
+ */
+size_t readChunk(int fd, uint8_t* buffer, size_t size) {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = read(fd, buffer + done, size - done);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Error de lectura: ") + std::strerror(errno));
+    }
+    if (n == 0) break;
+    done += static_cast<size_t>(n);
+  }
+  return done;
+}
+
+/**
+ * @brief Escribe el buffer completo, reintentando las escrituras parciales.
+ */
+void writeChunk(int fd, const uint8_t* buffer, size_t size) {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = write(fd, buffer + done, size - done);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Error de escritura: ") + std::strerror(errno));
+    }
+    done += static_cast<size_t>(n);
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Cifra (o descifra) la entrada por trozos con ChaCha20.
+ *
+ * Cada trozo se lee, se combina en el sitio con el keystream y se escribe
+ * antes de leer el siguiente; la memoria usada es kChunkSize sea cual sea el
+ * tamaño de la entrada. El cifrador conserva su posición, así que puede
+ * seguir usándose después.
+ *
+ * @param input Descriptor de lectura (fichero o tubería)
+ * @param output Descriptor de escritura
+ * @param cipher
+ * @return size_t Bytes procesados
+ */
+size_t encryptStream(int input, int output, ChaCha20& cipher) {
+  std::vector<uint8_t> buffer(kChunkSize);
+  size_t total = 0;
+  size_t length;
+  while ((length = readChunk(input, buffer.data(), buffer.size())) > 0) {
+    cipher.process(buffer.data(), length);
+    writeChunk(output, buffer.data(), length);
+    total += length;
+  }
+  return total;
+}
+
+/**
+ * @brief Cifra y autentica la entrada por trozos; al final escribe la etiqueta.
+ *
+ * @param input
+ * @param output
+ * @param aead Creado en modo kSeal (con los datos asociados ya añadidos)
+ * @return size_t Bytes de texto procesados (sin contar la etiqueta)
+ */
+size_t sealStream(int input, int output, ChaCha20Poly1305& aead) {
+  std::vector<uint8_t> buffer(kChunkSize);
+  size_t total = 0;
+  size_t length;
+  while ((length = readChunk(input, buffer.data(), buffer.size())) > 0) {
+    aead.update(buffer.data(), buffer.data(), length);
+    writeChunk(output, buffer.data(), length);
+    total += length;
+  }
+  uint8_t tag[kPoly1305TagSize];
+  aead.finishSeal(tag);
+  writeChunk(output, tag, sizeof(tag));
+  return total;
+}
+
+/**
+ * @brief Verifica y descifra una entrada sellada con sealStream.
+ *
+ * Los últimos 16 bytes de la entrada son la etiqueta, pero no se sabe cuáles
+ * son hasta llegar al final: cada trozo se procesa salvo sus 16 últimos
+ * bytes, que pasan al principio del siguiente. Lanza std::runtime_error si la
+ * etiqueta no coincide; lo ya escrito en la salida debe descartarse.
+ *
+ * @param input
+ * @param output
+ * @param aead Creado en modo kOpen (con los datos asociados ya añadidos)
+ * @return size_t Bytes de texto descifrados
+ */
+size_t openStream(int input, int output, ChaCha20Poly1305& aead) {
+  std::vector<uint8_t> buffer(kChunkSize + kPoly1305TagSize);
+  size_t total = 0;
+  size_t held = 0;
+  size_t length;
+  while ((length = readChunk(input, buffer.data() + held, kChunkSize)) > 0) {
+    held += length;
+    if (held <= kPoly1305TagSize) continue;
+    const size_t ready = held - kPoly1305TagSize;
+    aead.update(buffer.data(), buffer.data(), ready);
+    writeChunk(output, buffer.data(), ready);
+    std::memmove(buffer.data(), buffer.data() + ready, kPoly1305TagSize);
+    held = kPoly1305TagSize;
+    total += ready;
+  }
+  if (held < kPoly1305TagSize) throw std::runtime_error("La entrada es más corta que la etiqueta");
+  aead.finishOpen(buffer.data());
+  return total;
+}
+
+/**
+ * @brief Comprueba que [offset, offset + length) está dentro del fichero.
+ *
+ * @param file
+ * @param offset
+ * @param length
+ * @throw std::out_of_range Si el rango se sale del fichero
+ */
+void checkRange(const ArchivoMapeado& file, uint64_t offset, uint64_t length) {
+  if (offset > file.Tamano() || length > file.Tamano() - offset) {
+    throw std::out_of_range("El rango pedido supera el final del fichero");
+  }
+}
+
+/**
+ * @brief Descifra los bytes [offset, offset + output.size()) de un fichero proyectado.
+ *
+ * El cifrador salta directamente al bloque counter + offset / 64 y descarta
+ * los offset % 64 primeros bytes de su keystream; solo se leen las páginas
+ * del rango. Si el cifrador ya está en offset (rangos consecutivos), no hace
+ * falta saltar.
+ *
+ * @param file Fichero cifrado con la misma clave, nonce y contador que cipher
+ * @param cipher
+ * @param offset
+ * @param output
+ * @throw std::out_of_range Si el rango se sale del fichero
+ */
+void decryptRange(const ArchivoMapeado& file, ChaCha20& cipher, uint64_t offset, std::span<uint8_t> output) {
+  checkRange(file, offset, output.size());
+  if (output.empty()) return;
+  if (cipher.position() != offset) cipher.seek(offset);
+  cipher.xorTo(std::span<const uint8_t>(file.Datos() + offset, output.size()), output);
+}
+
+/**
+ * @brief Descifra [offset, offset + length) de un fichero proyectado y lo escribe en output.
+ *
+ * Se desactiva la lectura anticipada; el rango se recorre por trozos de
+ * kChunkSize, pidiendo cada trozo por adelantado y liberando sus páginas al
+ * terminar, así que la memoria no depende de length.
+ *
+ * @param file
+ * @param cipher
+ * @param offset
+ * @param length
+ * @param output Descriptor de salida
+ * @return size_t Bytes escritos
+ * @throw std::out_of_range Si el rango se sale del fichero
+ */
+size_t decryptRange(ArchivoMapeado& file, ChaCha20& cipher, uint64_t offset, uint64_t length, int output) {
+  checkRange(file, offset, length);
+  file.AccesoAleatorio();
+  std::vector<uint8_t> buffer(static_cast<size_t>(std::min<uint64_t>(kChunkSize, length)));
+  for (uint64_t done = 0; done < length;) {
+    const size_t size = static_cast<size_t>(std::min<uint64_t>(buffer.size(), length - done));
+    file.Precargar(offset + done, size);
+    decryptRange(file, cipher, offset + done, std::span<uint8_t>(buffer.data(), size));
+    file.Liberar(offset + done, size);
+    writeChunk(output, buffer.data(), size);
+    done += size;
+  }
+  return static_cast<size_t>(length);
+}
@@ -0,0 +1,158 @@
+#include "../include/lotes.h"
+#include "../include/chacha20_simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @brief Generador multi-buffer escalar: los kLanes bloques uno detrás de otro.
+ *
+ * @param lanes lanes[w * kLanes + l] es la palabra w del estado del carril l
+ * @param keystream Buffer de kLanes * kBlockSize bytes
+ */
+void chacha20LanesScalar(const uint32_t* lanes, uint8_t* keystream) {
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    uint32_t state[16];
+    for (size_t w = 0; w < 16; ++w) state[w] = lanes[w * kLanes + lane];
+    chacha20Block(state, keystream + lane * kBlockSize);
+  }
+}
+
+namespace {
+
+// Implementaciones disponibles en esta CPU, de la más lenta a la más rápida.
+std::vector<LanesImplementation> detectImplementations() {
+  std::vector<LanesImplementation> list = {{"escalar", chacha20LanesScalar}};
+#ifdef CHACHA20_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) {
+    list.push_back({"sse2", chacha20LanesSse2});
+    if (__builtin_cpu_supports("avx2")) list.push_back({"avx2", chacha20LanesAvx2});
+  }
+#endif
+  return list;
+}
+
+const LanesImplementation kActiveLanes = detectImplementations().back();
+
+/**
+ * @brief data ^= keystream, de 8 en 8 bytes.
+ */
+void xorKeystream(uint8_t* data, const uint8_t* keystream, size_t length) {
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t value, key;
+    std::memcpy(&value, data + i, 8);
+    std::memcpy(&key, keystream + i, 8);
+    value ^= key;
+    std::memcpy(data + i, &value, 8);
+  }
+  for (; i < length; ++i) data[i] ^= keystream[i];
+}
+
+/**
+ * @brief Comprueba todos los mensajes antes de tocar ninguno.
+ *
+ * @throw std::invalid_argument Si una clave o un nonce no tienen el tamaño correcto
+ * @throw std::overflow_error Si un mensaje necesita más bloques de los que le quedan a su contador
+ */
+void validate(std::span<const ChaCha20Job> jobs) {
+  for (const ChaCha20Job& job : jobs) {
+    if (job.key.size() != kKeySize) throw std::invalid_argument("La clave debe tener 32 bytes");
+    if (job.nonce.size() != kNonceSize && job.nonce.size() != kXNonceSize) {
+      throw std::invalid_argument("El nonce debe tener 12 bytes (24 con XChaCha20)");
+    }
+    const uint64_t blocks = (job.data.size() + kBlockSize - 1) / kBlockSize;
+    if (blocks > (uint64_t(1) << 32) - job.counter) {
+      throw std::overflow_error("Se ha agotado el contador de bloques de ChaCha20");
+    }
+  }
+}
+
+}  // namespace
+
+std::vector<LanesImplementation> lanesImplementations() { return detectImplementations(); }
+const char* activeLanesName() { return kActiveLanes.name; }
+
+/**
+ * @brief Cifra un lote de mensajes independientes con el generador elegido al arrancar.
+ *
+ * @param jobs
+ */
+void chacha20Batch(std::span<ChaCha20Job> jobs) {
+  chacha20Batch(jobs, kActiveLanes.function);
+}
+
+/**
+ * @brief Cifra un lote de mensajes independientes, un mensaje por carril.
+ *
+ * Cada carril lleva el estado de un mensaje; en cada paso se calcula un
+ * bloque de todos los carriles a la vez y cada uno lo combina con sus
+ * siguientes 64 bytes. Cuando un mensaje se acaba, su carril pasa al
+ * siguiente mensaje del lote, así que mensajes de 64 a 512 bytes aprovechan
+ * los 8 carriles de AVX2 igual que un mensaje largo. Si al final solo queda
+ * un mensaje, se termina con el generador normal, que sí reparte sus bloques
+ * entre los carriles.
+ *
+ * Sin memoria dinámica: los estados y el keystream están en la pila.
+ *
+ * @param jobs
+ * @param function Generador multi-buffer
+ */
+void chacha20Batch(std::span<ChaCha20Job> jobs, LanesFunction function) {
+  validate(jobs);
+
+  alignas(32) uint32_t lanes[16 * kLanes] = {};
+  alignas(32) uint8_t keystream[kLanes * kBlockSize];
+  ChaCha20Job* current[kLanes] = {};  // Mensaje de cada carril (nullptr si está libre)
+  size_t offset[kLanes] = {};         // Bytes ya cifrados del mensaje de cada carril
+  size_t next = 0, active = 0;
+
+  // Asigna al carril el siguiente mensaje no vacío; false si ya no quedan.
+  auto load = [&](size_t lane) {
+    current[lane] = nullptr;
+    while (next < jobs.size() && jobs[next].data.empty()) ++next;
+    if (next == jobs.size()) return false;
+    ChaCha20Job& job = jobs[next++];
+    ChaCha20State state;
+    initializeStreamState(state, job.key, job.counter, job.nonce);
+    for (size_t w = 0; w < 16; ++w) lanes[w * kLanes + lane] = state[w];
+    current[lane] = &job;
+    offset[lane] = 0;
+    return true;
+  };
+
+  for (size_t lane = 0; lane < kLanes; ++lane) active += load(lane);
+
+  // Mientras haya un carril libre no quedan mensajes por asignar, así que
+  // con uno solo activo ya no compensa calcular los 8.
+  while (active > 1) {
+    function(lanes, keystream);
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      ChaCha20Job* job = current[lane];
+      if (job == nullptr) continue;
+      const size_t take = std::min(kBlockSize, job->data.size() - offset[lane]);
+      xorKeystream(job->data.data() + offset[lane], keystream + lane * kBlockSize, take);
+      offset[lane] += take;
+      ++lanes[12 * kLanes + lane];
+      if (offset[lane] == job->data.size() && !load(lane)) --active;
+    }
+  }
+
+  // El último mensaje, si queda alguno, con el generador normal.
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    ChaCha20Job* job = current[lane];
+    if (job == nullptr) continue;
+    uint32_t state[16];
+    for (size_t w = 0; w < 16; ++w) state[w] = lanes[w * kLanes + lane];
+    while (offset[lane] < job->data.size()) {
+      const size_t length = std::min(sizeof(keystream), job->data.size() - offset[lane]);
+      const size_t blocks = (length + kBlockSize - 1) / kBlockSize;
+      chacha20Keystream(state, keystream, blocks);
+      xorKeystream(job->data.data() + offset[lane], keystream, length);
+      offset[lane] += length;
+      state[12] += static_cast<uint32_t>(blocks);
+    }
+  }
+}
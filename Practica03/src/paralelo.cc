@@ -0,0 +1,118 @@
+#include "../include/paralelo.h"
+#include "../include/chacha20.h"
+#include "../include/mapeo.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Escribe el buffer completo en una posición del fichero.
+ */
+void writeAt(int fd, const uint8_t* buffer, size_t size, size_t position) {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = pwrite(fd, buffer + done, size - done, static_cast<off_t>(position + done));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Error de escritura: ") + std::strerror(errno));
+    }
+    done += static_cast<size_t>(n);
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Cifra (o descifra) un fichero repartiendo trozos entre varios hilos.
+ *
+ * Cualquier bloque de ChaCha20 se calcula directamente a partir de su
+ * contador, así que el fichero se divide en trozos de kSegmentSize que los
+ * hilos toman de un contador compartido. Cada hilo coloca su cifrador al
+ * principio del trozo (seek), genera solo el keystream de ese rango y escribe
+ * el resultado con pwrite en su posición. La salida es la misma que la del
+ * modo flujo con la misma clave, nonce y contador.
+ *
+ * @param inputPath Fichero regular (se proyecta en memoria)
+ * @param outputPath Se crea o se trunca; no puede ser la entrada
+ * @param key 32 bytes
+ * @param nonce 12 bytes
+ * @param counter Contador del primer bloque
+ * @param threads 0 para usar todos los núcleos disponibles
+ * @return size_t Bytes procesados
+ */
+size_t encryptParallel(const std::string& inputPath, const std::string& outputPath, const std::vector<uint8_t>& key,
+                       const std::vector<uint8_t>& nonce, uint32_t counter, unsigned threads) {
+  // Se validan clave y nonce antes de tocar la salida.
+  ChaCha20 check(key, nonce, counter);
+
+  ArchivoMapeado input(inputPath);
+  const size_t size = input.Tamano();
+  if (size > ((uint64_t(1) << 32) - counter) * kBlockSize) {
+    throw std::invalid_argument("La entrada no cabe en el keystream que queda desde ese contador");
+  }
+  if (threads == 0) threads = std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+
+  // Sin O_TRUNC: si la salida fuera la entrada, se vaciaría mientras sigue proyectada.
+  int output = open(outputPath.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (output < 0) {
+    throw std::runtime_error("No se puede abrir " + outputPath + ": " + std::strerror(errno));
+  }
+  if (input.MismoArchivo(output)) {
+    close(output);
+    throw std::invalid_argument("La entrada y la salida son el mismo fichero");
+  }
+  // Se fija el tamaño final para que las escrituras posicionadas no dependan del orden.
+  if (ftruncate(output, static_cast<off_t>(size)) < 0) {
+    int error = errno;
+    close(output);
+    throw std::runtime_error("No se puede redimensionar " + outputPath + ": " + std::strerror(error));
+  }
+
+  const size_t segments = (size + kSegmentSize - 1) / kSegmentSize;
+  std::atomic<size_t> next(0);
+  std::atomic<bool> failed(false);
+  std::exception_ptr error;
+  auto worker = [&]() {
+    try {
+      ChaCha20 cipher(key, nonce, counter);
+      std::vector<uint8_t> buffer(kSegmentSize);
+      size_t segment;
+      while (!failed.load(std::memory_order_relaxed) &&
+             (segment = next.fetch_add(1, std::memory_order_relaxed)) < segments) {
+        const size_t start = segment * kSegmentSize;
+        const size_t length = std::min(kSegmentSize, size - start);
+        cipher.seek(start);
+        cipher.process(input.Datos() + start, buffer.data(), length);
+        writeAt(output, buffer.data(), length, start);
+      }
+    } catch (...) {
+      // Solo el primer hilo que falla guarda su excepción; el resto termina al ver failed.
+      if (!failed.exchange(true)) error = std::current_exception();
+    }
+  };
+  std::vector<std::thread> workers;
+  try {
+    for (unsigned i = 1; i < threads && i < segments; ++i) workers.emplace_back(worker);
+  } catch (...) {
+    // No se pudo crear un hilo: los ya creados terminan al ver failed y se unen abajo.
+    if (!failed.exchange(true)) error = std::current_exception();
+  }
+  worker();
+  for (std::thread& thread : workers) thread.join();
+  if (close(output) < 0 && !error) {
+    throw std::runtime_error("Error al cerrar " + outputPath + ": " + std::strerror(errno));
+  }
+  if (error) std::rethrow_exception(error);
+  return size;
+}
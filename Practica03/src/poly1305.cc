@@ -0,0 +1,212 @@
+#include "../include/poly1305.h"
+#include "../include/poly1305_simd.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+__extension__ typedef unsigned __int128 uint128;
+
+const uint64_t kMask44 = 0xfffffffffff;
+const uint64_t kMask42 = 0x3ffffffffff;
+// Bloques a partir de los cuales compensa preparar el camino vectorial.
+const size_t kSimdMinBlocks = 16;
+
+uint64_t load64(const uint8_t* bytes) {
+  uint64_t value = 0;
+  for (int i = 7; i >= 0; --i) value = (value << 8) | bytes[i];
+  return value;
+}
+
+void store64(uint8_t* bytes, uint64_t value) {
+  for (int i = 0; i < 8; ++i) bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+/**
+ * @brief h = h * r mod 2^130 - 5, con reducción parcial.
+ *
+ * Los productos que caen por encima de 2^130 se pliegan multiplicando por 5
+ * (2^130 = 5 mod p); como los limbs están a 44 bits, r1 y r2 entran ya
+ * multiplicados por 5 << 2.
+ */
+void multiply(uint64_t* h, const uint64_t* r) {
+  const uint64_t s1 = r[1] * (5 << 2), s2 = r[2] * (5 << 2);
+  const uint128 d0 = uint128(h[0]) * r[0] + uint128(h[1]) * s2 + uint128(h[2]) * s1;
+  uint128 d1 = uint128(h[0]) * r[1] + uint128(h[1]) * r[0] + uint128(h[2]) * s2;
+  uint128 d2 = uint128(h[0]) * r[2] + uint128(h[1]) * r[1] + uint128(h[2]) * r[0];
+  uint64_t c = static_cast<uint64_t>(d0 >> 44);
+  h[0] = static_cast<uint64_t>(d0) & kMask44;
+  d1 += c;
+  c = static_cast<uint64_t>(d1 >> 44);
+  h[1] = static_cast<uint64_t>(d1) & kMask44;
+  d2 += c;
+  c = static_cast<uint64_t>(d2 >> 42);
+  h[2] = static_cast<uint64_t>(d2) & kMask42;
+  h[0] += c * 5;
+  c = h[0] >> 44;
+  h[0] &= kMask44;
+  h[1] += c;
+}
+
+/**
+ * @brief Reduce h por completo: acarreos y, si h >= p, resta p.
+ */
+void reduce(uint64_t* h) {
+  uint64_t c;
+  for (int pass = 0; pass < 2; ++pass) {
+    c = h[1] >> 44; h[1] &= kMask44; h[2] += c;
+    c = h[2] >> 42; h[2] &= kMask42; h[0] += c * 5;
+    c = h[0] >> 44; h[0] &= kMask44; h[1] += c;
+  }
+  // g = h + 5 - 2^130; si no es negativo, h >= p y el resultado es g.
+  uint64_t g0 = h[0] + 5;
+  c = g0 >> 44; g0 &= kMask44;
+  uint64_t g1 = h[1] + c;
+  c = g1 >> 44; g1 &= kMask44;
+  uint64_t g2 = h[2] + c - (uint64_t(1) << 42);
+  // Máscara sin saltos: todo unos si g2 no ha dado la vuelta.
+  const uint64_t mask = (g2 >> 63) - 1;
+  h[0] = (h[0] & ~mask) | (g0 & mask);
+  h[1] = (h[1] & ~mask) | (g1 & mask);
+  h[2] = (h[2] & ~mask) | (g2 & mask);
+}
+
+#ifdef POLY1305_X86
+bool detectAvx2() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+}
+const bool kUseAvx2 = detectAvx2();
+#else
+const bool kUseAvx2 = false;
+#endif
+
+}  // namespace
+
+const char* activePoly1305Name() { return kUseAvx2 ? "avx2" : "escalar"; }
+
+/**
+ * @brief Prepara r (con los bits que exige el RFC puestos a cero) y s.
+ *
+ * @param key 32 bytes
+ */
+Poly1305::Poly1305(const uint8_t* key) : powersReady_(false), buffered_(0) {
+  const uint64_t t0 = load64(key), t1 = load64(key + 8);
+  r_[0] = t0 & 0xffc0fffffff;
+  r_[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffff;
+  r_[2] = (t1 >> 24) & 0x00ffffffc0f;
+  h_[0] = h_[1] = h_[2] = 0;
+  s_[0] = load64(key + 16);
+  s_[1] = load64(key + 24);
+}
+
+/**
+ * @brief Bloques completos de 16 bytes: h = (h + bloque + 2^128) * r.
+ *
+ * @param data
+ * @param count Número de bloques
+ */
+void Poly1305::blocks(const uint8_t* data, size_t count) {
+  for (size_t b = 0; b < count; ++b, data += kPoly1305BlockSize) {
+    const uint64_t t0 = load64(data), t1 = load64(data + 8);
+    h_[0] += t0 & kMask44;
+    h_[1] += ((t0 >> 44) | (t1 << 20)) & kMask44;
+    h_[2] += ((t1 >> 24) & kMask42) | (uint64_t(1) << 40);
+    multiply(h_, r_);
+  }
+}
+
+/**
+ * @brief Calcula r^1..r^4 la primera vez que se usa el camino vectorial.
+ */
+void Poly1305::preparePowers() {
+  std::memcpy(powers_[0], r_, sizeof(r_));
+  for (int k = 1; k < 4; ++k) {
+    std::memcpy(powers_[k], powers_[k - 1], sizeof(r_));
+    multiply(powers_[k], r_);
+  }
+  for (int k = 0; k < 4; ++k) reduce(powers_[k]);
+  powersReady_ = true;
+}
+
+/**
+ * @brief Añade datos al mensaje; se pueden pasar en trozos de cualquier tamaño.
+ *
+ * @param data
+ * @param length
+ */
+void Poly1305::update(const uint8_t* data, size_t length) {
+  if (buffered_ > 0) {
+    const size_t take = std::min(kPoly1305BlockSize - buffered_, length);
+    std::memcpy(buffer_ + buffered_, data, take);
+    buffered_ += take;
+    data += take;
+    length -= take;
+    if (buffered_ < kPoly1305BlockSize) return;
+    blocks(buffer_, 1);
+    buffered_ = 0;
+  }
+  size_t count = length / kPoly1305BlockSize;
+#ifdef POLY1305_X86
+  if (kUseAvx2 && count >= kSimdMinBlocks) {
+    if (!powersReady_) preparePowers();
+    const size_t done = poly1305BlocksAvx2(h_, powers_, data, count);
+    data += done * kPoly1305BlockSize;
+    length -= done * kPoly1305BlockSize;
+    count -= done;
+  }
+#endif
+  blocks(data, count);
+  data += count * kPoly1305BlockSize;
+  length -= count * kPoly1305BlockSize;
+  std::memcpy(buffer_, data, length);
+  buffered_ = length;
+}
+
+void Poly1305::pad() {
+  if (buffered_ == 0) return;
+  std::memset(buffer_ + buffered_, 0, kPoly1305BlockSize - buffered_);
+  blocks(buffer_, 1);
+  buffered_ = 0;
+}
+
+/**
+ * @brief Procesa el último bloque parcial y escribe la etiqueta (h + s) mod 2^128.
+ *
+ * El bloque parcial lleva un 1 tras el último byte en lugar del bit 2^128.
+ *
+ * @param tag 16 bytes
+ */
+void Poly1305::finish(uint8_t* tag) {
+  if (buffered_ > 0) {
+    buffer_[buffered_] = 1;
+    std::memset(buffer_ + buffered_ + 1, 0, kPoly1305BlockSize - buffered_ - 1);
+    const uint64_t t0 = load64(buffer_), t1 = load64(buffer_ + 8);
+    h_[0] += t0 & kMask44;
+    h_[1] += ((t0 >> 44) | (t1 << 20)) & kMask44;
+    h_[2] += (t1 >> 24) & kMask42;
+    multiply(h_, r_);
+    buffered_ = 0;
+  }
+  reduce(h_);
+  const uint64_t t0 = s_[0], t1 = s_[1];
+  uint64_t c;
+  h_[0] += t0 & kMask44;
+  c = h_[0] >> 44; h_[0] &= kMask44;
+  h_[1] += (((t0 >> 44) | (t1 << 20)) & kMask44) + c;
+  c = h_[1] >> 44; h_[1] &= kMask44;
+  h_[2] += ((t1 >> 24) & kMask42) + c;
+  h_[2] &= kMask42;
+  store64(tag, h_[0] | (h_[1] << 44));
+  store64(tag + 8, (h_[1] >> 20) | (h_[2] << 24));
+}
+
+/**
+ * @brief Compara sin salir antes de tiempo, para no revelar dónde difieren.
+ */
+bool constantTimeEqual(const uint8_t* a, const uint8_t* b, size_t length) {
+  uint8_t difference = 0;
+  for (size_t i = 0; i < length; ++i) difference |= a[i] ^ b[i];
+  return difference == 0;
+}
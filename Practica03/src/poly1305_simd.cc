@@ -0,0 +1,159 @@
+#include "../include/poly1305_simd.h"
+
+#ifdef POLY1305_X86
+
+#include <immintrin.h>
+
+namespace {
+
+__extension__ typedef unsigned __int128 uint128;
+
+const uint64_t kMask26 = 0x3ffffff;
+const uint64_t kMask44 = 0xfffffffffff;
+const uint64_t kMask42 = 0x3ffffffffff;
+
+/**
+ * @brief Pasa de 3 limbs de 44 bits a 5 limbs de 26 bits (el último puede pasar un poco de 26).
+ */
+void to26(const uint64_t* h, uint64_t* limbs) {
+  uint128 a = h[0] + (uint128(h[1]) << 44);
+  limbs[0] = static_cast<uint64_t>(a) & kMask26;
+  limbs[1] = static_cast<uint64_t>(a >> 26) & kMask26;
+  limbs[2] = static_cast<uint64_t>(a >> 52) & kMask26;
+  a = (a >> 78) + (uint128(h[2]) << 10);
+  limbs[3] = static_cast<uint64_t>(a) & kMask26;
+  limbs[4] = static_cast<uint64_t>(a >> 26);
+}
+
+/**
+ * @brief Pasa de 5 limbs de hasta 28 bits a 3 limbs de 44 bits, parcialmente reducidos.
+ */
+void to44(const uint64_t* limbs, uint64_t* h) {
+  uint128 a = limbs[0] + (uint128(limbs[1]) << 26) + (uint128(limbs[2]) << 52) + (uint128(limbs[3]) << 78);
+  h[0] = static_cast<uint64_t>(a) & kMask44;
+  a = (a >> 44) + (uint128(limbs[4]) << 60);
+  h[1] = static_cast<uint64_t>(a) & kMask44;
+  a >>= 44;
+  h[2] = static_cast<uint64_t>(a) & kMask42;
+  // Lo que pasa de 2^130 vuelve abajo multiplicado por 5.
+  h[0] += static_cast<uint64_t>(a >> 42) * 5;
+  h[1] += h[0] >> 44;
+  h[0] &= kMask44;
+}
+
+__attribute__((target("avx2"))) inline __m256i mul(__m256i a, __m256i b) {
+  return _mm256_mul_epu32(a, b);
+}
+
+/**
+ * @brief acc = acc * r mod 2^130 - 5 en los 4 carriles, con s = 5 * r.
+ *
+ * _mm256_mul_epu32 multiplica los 32 bits bajos de cada carril de 64; con
+ * limbs de 26 bits las sumas de 5 productos caben de sobra en 64 bits.
+ */
+__attribute__((target("avx2"))) inline void multiplyAvx2(__m256i* acc, const __m256i* r, const __m256i* s) {
+  const __m256i mask = _mm256_set1_epi64x(kMask26);
+  __m256i d0 = mul(acc[0], r[0]), d1 = mul(acc[0], r[1]), d2 = mul(acc[0], r[2]);
+  __m256i d3 = mul(acc[0], r[3]), d4 = mul(acc[0], r[4]);
+  d0 = _mm256_add_epi64(d0, mul(acc[1], s[4]));
+  d1 = _mm256_add_epi64(d1, mul(acc[1], r[0]));
+  d2 = _mm256_add_epi64(d2, mul(acc[1], r[1]));
+  d3 = _mm256_add_epi64(d3, mul(acc[1], r[2]));
+  d4 = _mm256_add_epi64(d4, mul(acc[1], r[3]));
+  d0 = _mm256_add_epi64(d0, mul(acc[2], s[3]));
+  d1 = _mm256_add_epi64(d1, mul(acc[2], s[4]));
+  d2 = _mm256_add_epi64(d2, mul(acc[2], r[0]));
+  d3 = _mm256_add_epi64(d3, mul(acc[2], r[1]));
+  d4 = _mm256_add_epi64(d4, mul(acc[2], r[2]));
+  d0 = _mm256_add_epi64(d0, mul(acc[3], s[2]));
+  d1 = _mm256_add_epi64(d1, mul(acc[3], s[3]));
+  d2 = _mm256_add_epi64(d2, mul(acc[3], s[4]));
+  d3 = _mm256_add_epi64(d3, mul(acc[3], r[0]));
+  d4 = _mm256_add_epi64(d4, mul(acc[3], r[1]));
+  d0 = _mm256_add_epi64(d0, mul(acc[4], s[1]));
+  d1 = _mm256_add_epi64(d1, mul(acc[4], s[2]));
+  d2 = _mm256_add_epi64(d2, mul(acc[4], s[3]));
+  d3 = _mm256_add_epi64(d3, mul(acc[4], s[4]));
+  d4 = _mm256_add_epi64(d4, mul(acc[4], r[0]));
+  // Acarreos: cada limb vuelve a 26 bits; lo que sale del último entra por abajo por 5.
+  d1 = _mm256_add_epi64(d1, _mm256_srli_epi64(d0, 26)); d0 = _mm256_and_si256(d0, mask);
+  d2 = _mm256_add_epi64(d2, _mm256_srli_epi64(d1, 26)); d1 = _mm256_and_si256(d1, mask);
+  d3 = _mm256_add_epi64(d3, _mm256_srli_epi64(d2, 26)); d2 = _mm256_and_si256(d2, mask);
+  d4 = _mm256_add_epi64(d4, _mm256_srli_epi64(d3, 26)); d3 = _mm256_and_si256(d3, mask);
+  const __m256i carry = _mm256_srli_epi64(d4, 26);
+  d4 = _mm256_and_si256(d4, mask);
+  d0 = _mm256_add_epi64(d0, _mm256_add_epi64(carry, _mm256_slli_epi64(carry, 2)));
+  d1 = _mm256_add_epi64(d1, _mm256_srli_epi64(d0, 26)); d0 = _mm256_and_si256(d0, mask);
+  acc[0] = d0; acc[1] = d1; acc[2] = d2; acc[3] = d3; acc[4] = d4;
+}
+
+}  // namespace
+
+/**
+ * @brief Poly1305 de 4 en 4 bloques con AVX2.
+ *
+ * El carril i acumula los bloques 4k + i: en cada grupo se suma el bloque y
+ * se multiplica por r^4. En el último grupo el carril i se multiplica por
+ * r^(4-i) en lugar de r^4, de modo que la suma de los carriles es
+ * exactamente el h que daría el recorrido escalar bloque a bloque.
+ *
+ * @param h Acumulador escalar (3 limbs de 44 bits); se actualiza
+ * @param powers r^1..r^4
+ * @param data
+ * @param blocks Bloques disponibles; se procesan los de los grupos completos de 4
+ * @return size_t Bloques procesados
+ */
+__attribute__((target("avx2"))) size_t poly1305BlocksAvx2(uint64_t* h, const uint64_t (*powers)[3],
+                                                          const uint8_t* data, size_t blocks) {
+  const size_t groups = blocks / 4;
+  if (groups == 0) return 0;
+
+  uint64_t limbs[4][5], start[5];
+  for (int k = 0; k < 4; ++k) to26(powers[k], limbs[k]);
+  to26(h, start);
+  __m256i r4[5], s4[5], rLast[5], sLast[5], acc[5];
+  for (int j = 0; j < 5; ++j) {
+    r4[j] = _mm256_set1_epi64x(static_cast<long long>(limbs[3][j]));
+    s4[j] = _mm256_set1_epi64x(static_cast<long long>(limbs[3][j] * 5));
+    // Carril 0: r^4 ... carril 3: r^1.
+    rLast[j] = _mm256_set_epi64x(static_cast<long long>(limbs[0][j]), static_cast<long long>(limbs[1][j]),
+                                 static_cast<long long>(limbs[2][j]), static_cast<long long>(limbs[3][j]));
+    sLast[j] = _mm256_set_epi64x(static_cast<long long>(limbs[0][j] * 5), static_cast<long long>(limbs[1][j] * 5),
+                                 static_cast<long long>(limbs[2][j] * 5), static_cast<long long>(limbs[3][j] * 5));
+    // El h que ya había se suma al primer bloque, en el carril 0.
+    acc[j] = _mm256_set_epi64x(0, 0, 0, static_cast<long long>(start[j]));
+  }
+
+  const __m256i mask = _mm256_set1_epi64x(kMask26);
+  const __m256i high_bit = _mm256_set1_epi64x(1 << 24);
+  for (size_t g = 0; g < groups; ++g, data += 64) {
+    // Mitades baja y alta de los 4 bloques, un bloque por carril.
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+    const __m256i low = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), 0xD8);
+    const __m256i high = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), 0xD8);
+    acc[0] = _mm256_add_epi64(acc[0], _mm256_and_si256(low, mask));
+    acc[1] = _mm256_add_epi64(acc[1], _mm256_and_si256(_mm256_srli_epi64(low, 26), mask));
+    acc[2] = _mm256_add_epi64(
+        acc[2], _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(low, 52), _mm256_slli_epi64(high, 12)), mask));
+    acc[3] = _mm256_add_epi64(acc[3], _mm256_and_si256(_mm256_srli_epi64(high, 14), mask));
+    acc[4] = _mm256_add_epi64(acc[4], _mm256_or_si256(_mm256_srli_epi64(high, 40), high_bit));
+    if (g + 1 < groups) {
+      multiplyAvx2(acc, r4, s4);
+    } else {
+      multiplyAvx2(acc, rLast, sLast);
+    }
+  }
+
+  // Suma de los 4 carriles, limb a limb.
+  uint64_t sum[5];
+  for (int j = 0; j < 5; ++j) {
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc[j]);
+    sum[j] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  }
+  to44(sum, h);
+  return groups * 4;
+}
+
+#endif  // POLY1305_X86
@@ -0,0 +1,506 @@
+#include "../include/tuberia.h"
+#include "../include/chacha20.h"
+#include "../include/mapeo.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// io_uring sin liburing: las llamadas al sistema se hacen directamente. Si la
+// cabecera no existe se compila solo el camino de pread/pwrite.
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define PIPELINE_URING 1
+#endif
+#endif
+
+namespace {
+
+/**
+ * @brief Cola de lecturas y escrituras posicionadas de un solo hilo.
+ *
+ * Con io_uring las operaciones se apuntan en el anillo de envío y submit()
+ * las manda todas con una llamada al sistema; complete() espera a que acabe
+ * una cualquiera. Sin io_uring (no compilado, el núcleo no lo permite o no
+ * conoce IORING_OP_READ/WRITE) read() y write() hacen pread/pwrite en el
+ * momento y complete() devuelve las etiquetas en el mismo orden.
+ */
+class IoQueue {
+ public:
+  IoQueue(unsigned depth, IoBackend backend);
+  ~IoQueue();
+
+  IoQueue(const IoQueue&) = delete;
+  IoQueue& operator=(const IoQueue&) = delete;
+
+  void read(int fd, uint8_t* buffer, size_t length, uint64_t offset, uint64_t tag);
+  void write(int fd, uint8_t* buffer, size_t length, uint64_t offset, uint64_t tag);
+  void submit();
+  uint64_t complete();
+
+  // Operaciones apuntadas cuya etiqueta aún no ha devuelto complete().
+  size_t pending() const { return pending_; }
+  bool usesUring() const { return useRing_; }
+
+ private:
+  struct Request {
+    int fd;
+    uint8_t* buffer;
+    size_t length;
+    uint64_t offset;
+    uint64_t tag;
+    bool writing;
+  };
+
+  void enqueue(const Request& request);
+  static void perform(Request request);
+
+  std::vector<Request> requests_;  // Operaciones en el anillo, por índice (user_data)
+  std::vector<unsigned> free_;     // Índices libres de requests_
+  std::deque<uint64_t> done_;      // Etiquetas ya terminadas con pread/pwrite
+  size_t pending_;
+  bool useRing_;
+
+#ifdef PIPELINE_URING
+  bool setupRing(unsigned depth);
+  bool reap(unsigned& index, int& result);
+
+  int ring_ = -1;
+  void* sqRing_ = nullptr;
+  size_t sqRingSize_ = 0;
+  void* cqRing_ = nullptr;
+  size_t cqRingSize_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqesSize_ = 0;
+  unsigned* sqTail_ = nullptr;
+  unsigned sqMask_ = 0;
+  unsigned* sqArray_ = nullptr;
+  unsigned* cqHead_ = nullptr;
+  unsigned* cqTail_ = nullptr;
+  unsigned cqMask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+  unsigned unsubmitted_ = 0;  // Entradas escritas en el anillo y no enviadas aún
+  unsigned inRing_ = 0;       // Operaciones enviadas o por enviar al núcleo
+#endif
+};
+
+IoQueue::IoQueue(unsigned depth, IoBackend backend) : requests_(depth), pending_(0), useRing_(false) {
+  for (unsigned i = depth; i-- > 0;) free_.push_back(i);
+#ifdef PIPELINE_URING
+  if (backend == kIoAutomatic) useRing_ = setupRing(depth);
+#else
+  (void)backend;
+#endif
+}
+
+IoQueue::~IoQueue() {
+#ifdef PIPELINE_URING
+  // El núcleo no debe seguir escribiendo en buffers que el llamador va a liberar.
+  try {
+    submit();
+    unsigned index;
+    int result;
+    while (inRing_ > 0 && reap(index, result)) {
+    }
+  } catch (...) {
+  }
+  if (sqes_ != nullptr) munmap(sqes_, sqesSize_);
+  if (cqRing_ != nullptr && cqRing_ != sqRing_) munmap(cqRing_, cqRingSize_);
+  if (sqRing_ != nullptr) munmap(sqRing_, sqRingSize_);
+  if (ring_ >= 0) close(ring_);
+#endif
+}
+
+#ifdef PIPELINE_URING
+/**
+ * @brief Crea el anillo y proyecta sus colas; false si el núcleo no lo permite.
+ */
+bool IoQueue::setupRing(unsigned depth) {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  // La cola de terminación es el doble de la de envío: nunca se desborda.
+  ring_ = static_cast<int>(syscall(__NR_io_uring_setup, depth, &params));
+  if (ring_ < 0) return false;
+
+  sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single) sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+  sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_, IORING_OFF_SQ_RING);
+  if (sqRing_ == MAP_FAILED) {
+    sqRing_ = nullptr;
+    return false;
+  }
+  cqRing_ = single ? sqRing_
+                   : mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_,
+                          IORING_OFF_CQ_RING);
+  if (cqRing_ == MAP_FAILED) {
+    cqRing_ = nullptr;
+    return false;
+  }
+  sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) return false;
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  uint8_t* sq = static_cast<uint8_t*>(sqRing_);
+  uint8_t* cq = static_cast<uint8_t*>(cqRing_);
+  sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+  return true;
+}
+
+/**
+ * @brief Saca una entrada de la cola de terminación, esperando si está vacía.
+ *
+ * @param index Índice de la operación en requests_
+ * @param result Bytes transferidos o -errno
+ * @return bool false si no queda nada en el anillo
+ */
+bool IoQueue::reap(unsigned& index, int& result) {
+  if (inRing_ == 0) return false;
+  for (;;) {
+    const unsigned head = std::atomic_ref<unsigned>(*cqHead_).load(std::memory_order_relaxed);
+    const unsigned tail = std::atomic_ref<unsigned>(*cqTail_).load(std::memory_order_acquire);
+    if (head != tail) {
+      const io_uring_cqe& cqe = cqes_[head & cqMask_];
+      index = static_cast<unsigned>(cqe.user_data);
+      result = cqe.res;
+      std::atomic_ref<unsigned>(*cqHead_).store(head + 1, std::memory_order_release);
+      --inRing_;
+      return true;
+    }
+    if (syscall(__NR_io_uring_enter, ring_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+      throw std::runtime_error(std::string("Error de io_uring: ") + std::strerror(errno));
+    }
+  }
+}
+#endif
+
+/**
+ * @brief pread/pwrite completos, reintentando las transferencias parciales.
+ */
+void IoQueue::perform(Request request) {
+  while (request.length > 0) {
+    ssize_t n = request.writing ? pwrite(request.fd, request.buffer, request.length, static_cast<off_t>(request.offset))
+                                : pread(request.fd, request.buffer, request.length, static_cast<off_t>(request.offset));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string(request.writing ? "Error de escritura: " : "Error de lectura: ") +
+                               std::strerror(errno));
+    }
+    if (n == 0) {
+      throw std::runtime_error(request.writing ? "Error de escritura: no se escribió nada"
+                                               : "El fichero de entrada ha cambiado de tamaño");
+    }
+    request.buffer += n;
+    request.offset += static_cast<uint64_t>(n);
+    request.length -= static_cast<size_t>(n);
+  }
+}
+
+void IoQueue::enqueue(const Request& request) {
+  if (!useRing_) {
+    perform(request);
+    done_.push_back(request.tag);
+    ++pending_;
+    return;
+  }
+#ifdef PIPELINE_URING
+  if (free_.empty()) throw std::logic_error("La cola de E/S está llena");
+  const unsigned index = free_.back();
+  free_.pop_back();
+  requests_[index] = request;
+  const unsigned tail = *sqTail_;
+  io_uring_sqe* sqe = &sqes_[tail & sqMask_];
+  std::memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = request.writing ? IORING_OP_WRITE : IORING_OP_READ;
+  sqe->fd = request.fd;
+  sqe->addr = reinterpret_cast<uintptr_t>(request.buffer);
+  sqe->len = static_cast<uint32_t>(request.length);
+  sqe->off = request.offset;
+  sqe->user_data = index;
+  sqArray_[tail & sqMask_] = tail & sqMask_;
+  std::atomic_ref<unsigned>(*sqTail_).store(tail + 1, std::memory_order_release);
+  ++unsubmitted_;
+  ++inRing_;
+  ++pending_;
+#endif
+}
+
+void IoQueue::read(int fd, uint8_t* buffer, size_t length, uint64_t offset, uint64_t tag) {
+  enqueue({fd, buffer, length, offset, tag, false});
+}
+
+void IoQueue::write(int fd, uint8_t* buffer, size_t length, uint64_t offset, uint64_t tag) {
+  enqueue({fd, buffer, length, offset, tag, true});
+}
+
+/**
+ * @brief Envía al núcleo, con una sola llamada, todo lo apuntado desde el último envío.
+ */
+void IoQueue::submit() {
+#ifdef PIPELINE_URING
+  while (unsubmitted_ > 0) {
+    long n = syscall(__NR_io_uring_enter, ring_, unsubmitted_, 0, 0, nullptr, 0);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Error de io_uring: ") + std::strerror(errno));
+    }
+    unsubmitted_ -= static_cast<unsigned>(n);
+  }
+#endif
+}
+
+/**
+ * @brief Espera a que termine una operación y devuelve su etiqueta.
+ *
+ * Una transferencia parcial se completa con pread/pwrite. Si el núcleo no
+ * conoce las operaciones de lectura o escritura de io_uring, la operación se
+ * repite con pread/pwrite y las siguientes ya no pasan por el anillo.
+ *
+ * @return uint64_t
+ */
+uint64_t IoQueue::complete() {
+  if (pending_ == 0) throw std::logic_error("No hay operaciones de E/S pendientes");
+  --pending_;
+  if (!done_.empty()) {
+    const uint64_t tag = done_.front();
+    done_.pop_front();
+    return tag;
+  }
+#ifdef PIPELINE_URING
+  submit();
+  unsigned index;
+  int result;
+  reap(index, result);
+  Request request = requests_[index];
+  free_.push_back(index);
+  if (result == -EINVAL || result == -EOPNOTSUPP) {
+    useRing_ = false;
+    perform(request);
+  } else if (result < 0) {
+    throw std::runtime_error(std::string(request.writing ? "Error de escritura: " : "Error de lectura: ") +
+                             std::strerror(-result));
+  } else if (static_cast<size_t>(result) < request.length) {
+    request.buffer += result;
+    request.offset += static_cast<uint64_t>(result);
+    request.length -= static_cast<size_t>(result);
+    perform(request);
+  }
+  return request.tag;
+#else
+  throw std::logic_error("No hay operaciones de E/S pendientes");
+#endif
+}
+
+// Estado de cada buffer del anillo de la tubería.
+enum SlotState { kFree, kReading, kRead, kEncrypting, kEncrypted, kWriting };
+
+}  // namespace
+
+/**
+ * @brief Indica si io_uring funciona en este sistema (compilado y permitido por el núcleo).
+ */
+bool ioUringAvailable() {
+  static const bool available = IoQueue(1, kIoAutomatic).usesUring();
+  return available;
+}
+
+/**
+ * @brief Cifra (o descifra) un fichero con una tubería de tres etapas.
+ *
+ * Un hilo lector llena un anillo de buffers de kPipelineChunkSize, los
+ * trabajadores cifran cada buffer en el sitio (seek al principio del trozo) y
+ * un hilo escritor los vuelca en orden. Así la lectura, el cifrado y la
+ * escritura se solapan en vez de alternarse. El lector y el escritor envían
+ * de una vez todas las operaciones que tienen listas: con io_uring, una
+ * llamada al sistema para varias lecturas o escrituras en curso; si no, con
+ * pread/pwrite.
+ *
+ * El trozo i ocupa el buffer i % buffers; el lector solo lo reutiliza cuando
+ * el escritor ha terminado con el trozo anterior que lo ocupaba. La salida es
+ * la misma que la del modo flujo con la misma clave, nonce y contador.
+ *
+ * @param inputPath Fichero regular
+ * @param outputPath Se crea o se trunca; no puede ser la entrada
+ * @param key 32 bytes
+ * @param nonce 12 bytes (ChaCha20) o 24 (XChaCha20)
+ * @param counter Contador del primer bloque
+ * @param workers Hilos de cifrado; 0 para usar todos los núcleos disponibles
+ * @param backend kIoAutomatic (io_uring si se puede) o kIoPread
+ * @return size_t Bytes procesados
+ */
+size_t encryptPipeline(const std::string& inputPath, const std::string& outputPath, const std::vector<uint8_t>& key,
+                       const std::vector<uint8_t>& nonce, uint32_t counter, unsigned workers, IoBackend backend) {
+  // Se validan clave y nonce antes de tocar la salida.
+  ChaCha20 check(key, nonce, counter);
+
+  int input = open(inputPath.c_str(), O_RDONLY);
+  if (input < 0) throw std::runtime_error("No se puede abrir " + inputPath + ": " + std::strerror(errno));
+  struct stat info;
+  if (fstat(input, &info) < 0) {
+    int error = errno;
+    close(input);
+    throw std::runtime_error("No se puede consultar " + inputPath + ": " + std::strerror(error));
+  }
+  const size_t size = static_cast<size_t>(info.st_size);
+  if (size > ((uint64_t(1) << 32) - counter) * kBlockSize) {
+    close(input);
+    throw std::invalid_argument("La entrada no cabe en el keystream que queda desde ese contador");
+  }
+  posix_fadvise(input, 0, 0, POSIX_FADV_SEQUENTIAL);
+  if (workers == 0) workers = std::thread::hardware_concurrency();
+  if (workers == 0) workers = 1;
+
+  // Sin O_TRUNC: si la salida fuera la entrada, se vaciaría antes de leerla.
+  int output = open(outputPath.c_str(), O_WRONLY | O_CREAT, 0644);
+  if (output < 0) {
+    int error = errno;
+    close(input);
+    throw std::runtime_error("No se puede abrir " + outputPath + ": " + std::strerror(error));
+  }
+  if (MismoArchivo(input, output)) {
+    close(input);
+    close(output);
+    throw std::invalid_argument("La entrada y la salida son el mismo fichero");
+  }
+  if (ftruncate(output, static_cast<off_t>(size)) < 0) {
+    int error = errno;
+    close(input);
+    close(output);
+    throw std::runtime_error("No se puede redimensionar " + outputPath + ": " + std::strerror(error));
+  }
+
+  const size_t chunks = (size + kPipelineChunkSize - 1) / kPipelineChunkSize;
+  // Dos buffers por trabajador y margen para el lector y el escritor.
+  const size_t slots = std::max<size_t>(1, std::min<size_t>(chunks, 2 * size_t(workers) + 4));
+  std::vector<std::vector<uint8_t>> buffers(slots, std::vector<uint8_t>(std::min(size, kPipelineChunkSize)));
+  std::vector<SlotState> states(slots, kFree);
+  std::vector<size_t> owner(slots, 0);  // Trozo que ocupa cada buffer
+  std::mutex mutex;
+  std::condition_variable changed;
+  size_t nextChunk = 0;  // Siguiente trozo que toma un trabajador
+  bool failed = false;
+  std::exception_ptr error;
+
+  auto length = [&](size_t chunk) { return std::min(kPipelineChunkSize, size - chunk * kPipelineChunkSize); };
+  auto fail = [&]() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      // Solo se guarda la primera excepción; el resto de hilos termina al ver failed.
+      if (!failed) error = std::current_exception();
+      failed = true;
+    }
+    changed.notify_all();
+  };
+  auto release = [&](size_t slot, SlotState state) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      states[slot] = state;
+    }
+    changed.notify_all();
+  };
+
+  // Etapas de E/S (lector y escritor): apuntan todos los trozos listos, los
+  // envían juntos y esperan a que termine uno. Si no hay nada en curso,
+  // esperan a que otra etapa deje listo el siguiente trozo.
+  auto ioStage = [&](SlotState ready, SlotState busy, SlotState finished, bool writing) {
+    try {
+      IoQueue queue(static_cast<unsigned>(slots), backend);
+      std::vector<size_t> batch;
+      size_t next = 0;
+      for (size_t done = 0; done < chunks; ++done) {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          auto isReady = [&]() {
+            const size_t slot = next % slots;
+            return states[slot] == ready && (writing ? owner[slot] == next : true);
+          };
+          if (queue.pending() == 0) changed.wait(lock, [&] { return failed || isReady(); });
+          if (failed) return;
+          // Con pread/pwrite cada operación bloquea: se hace una y se entrega, sin acumular.
+          for (; next < chunks && isReady() && (queue.usesUring() || batch.empty()); ++next) {
+            states[next % slots] = busy;
+            owner[next % slots] = next;
+            batch.push_back(next);
+          }
+        }
+        for (size_t chunk : batch) {
+          uint8_t* buffer = buffers[chunk % slots].data();
+          if (writing) {
+            queue.write(output, buffer, length(chunk), chunk * kPipelineChunkSize, chunk);
+          } else {
+            queue.read(input, buffer, length(chunk), chunk * kPipelineChunkSize, chunk);
+          }
+        }
+        batch.clear();
+        queue.submit();
+        release(static_cast<size_t>(queue.complete()) % slots, finished);
+      }
+    } catch (...) {
+      fail();
+    }
+  };
+
+  auto worker = [&]() {
+    try {
+      ChaCha20 cipher(key, nonce, counter);
+      for (;;) {
+        size_t chunk;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          if (failed || nextChunk == chunks) return;
+          chunk = nextChunk++;
+          const size_t slot = chunk % slots;
+          changed.wait(lock, [&] { return failed || (states[slot] == kRead && owner[slot] == chunk); });
+          if (failed) return;
+          states[chunk % slots] = kEncrypting;
+        }
+        cipher.seek(chunk * kPipelineChunkSize);
+        cipher.process(buffers[chunk % slots].data(), length(chunk));
+        release(chunk % slots, kEncrypted);
+      }
+    } catch (...) {
+      fail();
+    }
+  };
+
+  // Lector, escritor y trabajadores; el hilo que llama también cifra.
+  std::vector<std::thread> threads;
+  try {
+    threads.emplace_back(ioStage, kFree, kReading, kRead, false);
+    threads.emplace_back(ioStage, kEncrypted, kWriting, kFree, true);
+    for (unsigned i = 1; i < workers && i < chunks; ++i) threads.emplace_back(worker);
+  } catch (...) {
+    // No se pudo crear un hilo: los ya creados terminan al ver failed y se unen abajo.
+    fail();
+  }
+  worker();
+  for (std::thread& thread : threads) thread.join();
+  close(input);
+  if (close(output) < 0 && !error) {
+    throw std::runtime_error("Error al cerrar " + outputPath + ": " + std::strerror(errno));
+  }
+  if (error) std::rethrow_exception(error);
+  return size;
+}
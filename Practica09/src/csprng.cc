@@ -0,0 +1,177 @@
+#include "../include/csprng.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <string.h>
+#include <sys/random.h>
+
+// Bloques que se generan con una misma clave cuando la salida va directa al destino.
+static const size_t kCsprngMaxBlocks = size_t(1) << 16;
+
+static inline uint32_t rotateLeft(uint32_t value, int shift) { return (value << shift) | (value >> (32 - shift)); }
+
+static inline void quarter(uint32_t* x, int a, int b, int c, int d) {
+  x[a] += x[b]; x[d] = rotateLeft(x[d] ^ x[a], 16);
+  x[c] += x[d]; x[b] = rotateLeft(x[b] ^ x[c], 12);
+  x[a] += x[b]; x[d] = rotateLeft(x[d] ^ x[a], 8);
+  x[c] += x[d]; x[b] = rotateLeft(x[b] ^ x[c], 7);
+}
+
+/**
+ * @brief Bloque de ChaCha20 con la clave, el contador y el nonce indicados.
+ *
+ * Es una copia mínima del bloque de la RFC 8439 para que el generador no
+ * dependa del resto de la práctica; blockMatchesRfc() la comprueba.
+ */
+static void block(const uint32_t* key, uint32_t counter, const uint32_t* nonce, uint8_t* output) {
+  uint32_t state[16] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+  std::memcpy(state + 4, key, 32);
+  state[12] = counter;
+  std::memcpy(state + 13, nonce, 12);
+  uint32_t x[16];
+  std::memcpy(x, state, sizeof(x));
+  for (int i = 0; i < 10; ++i) {
+    quarter(x, 0, 4, 8, 12);
+    quarter(x, 1, 5, 9, 13);
+    quarter(x, 2, 6, 10, 14);
+    quarter(x, 3, 7, 11, 15);
+    quarter(x, 0, 5, 10, 15);
+    quarter(x, 1, 6, 11, 12);
+    quarter(x, 2, 7, 8, 13);
+    quarter(x, 3, 4, 9, 14);
+  }
+  for (int i = 0; i < 16; ++i) {
+    uint32_t word = x[i] + state[i];
+    output[4 * i] = static_cast<uint8_t>(word);
+    output[4 * i + 1] = static_cast<uint8_t>(word >> 8);
+    output[4 * i + 2] = static_cast<uint8_t>(word >> 16);
+    output[4 * i + 3] = static_cast<uint8_t>(word >> 24);
+  }
+  explicit_bzero(x, sizeof(x));
+  explicit_bzero(state, sizeof(state));
+}
+
+static const uint32_t kZeroNonce[3] = {0, 0, 0};
+
+/**
+ * @brief Comprueba block() con el vector de la sección 2.3.2 de la RFC 8439.
+ *
+ * La clave es 00 01 ... 1f, el contador 1 y el nonce 00:00:00:09:00:00:00:4a:00:00:00:00.
+ */
+static bool blockMatchesRfc() {
+  static const uint8_t kExpected[64] = {
+      0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3, 0x20, 0x71, 0xc4,
+      0xc7, 0xd1, 0xf4, 0xc7, 0x33, 0xc0, 0x68, 0x03, 0x04, 0x22, 0xaa, 0x9a, 0xc3, 0xd4, 0x6c, 0x4e,
+      0xd2, 0x82, 0x64, 0x46, 0x07, 0x9f, 0xaa, 0x09, 0x14, 0xc2, 0xd7, 0x05, 0xd9, 0x8b, 0x02, 0xa2,
+      0xb5, 0x12, 0x9c, 0xd1, 0xde, 0x16, 0x4e, 0xb9, 0xcb, 0xd0, 0x83, 0xe8, 0xa2, 0x50, 0x3c, 0x4e};
+  uint32_t key[8];
+  for (uint32_t i = 0; i < 8; ++i) {
+    key[i] = (4 * i) | ((4 * i + 1) << 8) | ((4 * i + 2) << 16) | ((4 * i + 3) << 24);
+  }
+  const uint32_t nonce[3] = {0x09000000, 0x4a000000, 0};
+  uint8_t output[64];
+  block(key, 1, nonce, output);
+  return std::memcmp(output, kExpected, sizeof(output)) == 0;
+}
+
+/**
+ * @brief Crea el generador con una clave de getrandom().
+ *
+ * @throw std::runtime_error Si el sistema no puede dar bytes aleatorios
+ * @throw std::logic_error Si el bloque no reproduce el vector de la RFC 8439
+ */
+Csprng::Csprng() : used_(sizeof(buffer_)) {
+  static const bool kBlockOk = blockMatchesRfc();
+  if (!kBlockOk) throw std::logic_error("El bloque ChaCha20 del generador no cumple el RFC 8439");
+  uint8_t* seed = reinterpret_cast<uint8_t*>(key_);
+  for (size_t got = 0; got < sizeof(key_);) {
+    ssize_t n = getrandom(seed + got, sizeof(key_) - got, 0);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("No se puede obtener la semilla: ") + std::strerror(errno));
+    }
+    got += static_cast<size_t>(n);
+  }
+}
+
+Csprng::~Csprng() {
+  explicit_bzero(key_, sizeof(key_));
+  explicit_bzero(buffer_, sizeof(buffer_));
+}
+
+Csprng& Csprng::threadLocal() {
+  static thread_local Csprng generator;
+  return generator;
+}
+
+/**
+ * @brief Escribe `blocks` bloques de keystream en output y cambia la clave.
+ *
+ * La salida usa los contadores 1..blocks y la clave nueva sale del bloque 0,
+ * así que nunca coincide con bytes entregados.
+ */
+void Csprng::generate(uint8_t* output, size_t blocks) {
+  for (size_t i = 0; i < blocks; ++i) block(key_, static_cast<uint32_t>(i + 1), kZeroNonce, output + 64 * i);
+  uint8_t next[64];
+  block(key_, 0, kZeroNonce, next);
+  std::memcpy(key_, next, sizeof(key_));
+  explicit_bzero(next, sizeof(next));
+}
+
+void Csprng::refill() {
+  generate(buffer_, kCsprngBlocks);
+  used_ = 0;
+}
+
+/**
+ * @brief Rellena output con bytes aleatorios.
+ *
+ * Primero se gasta lo que queda en el buffer; los bloques completos de una
+ * petición grande se generan directamente en output, sin pasar por él.
+ */
+void Csprng::fill(uint8_t* output, size_t length) {
+  size_t take = std::min(length, sizeof(buffer_) - used_);
+  std::memcpy(output, buffer_ + used_, take);
+  explicit_bzero(buffer_ + used_, take);
+  used_ += take;
+  output += take;
+  length -= take;
+
+  while (length >= sizeof(buffer_)) {
+    size_t blocks = std::min(length / 64, kCsprngMaxBlocks);
+    generate(output, blocks);
+    output += 64 * blocks;
+    length -= 64 * blocks;
+  }
+
+  if (length > 0) {
+    refill();
+    std::memcpy(output, buffer_, length);
+    explicit_bzero(buffer_, length);
+    used_ = length;
+  }
+}
+
+void Csprng::fill(std::span<uint8_t> output) { fill(output.data(), output.size()); }
+
+/**
+ * @brief Entero uniforme en [0, bound) por rechazo.
+ *
+ * Se descartan los valores por debajo de 2^64 mod bound, de modo que los que
+ * quedan son un múltiplo exacto de bound.
+ *
+ * @throw std::invalid_argument Si bound es 0
+ */
+uint64_t Csprng::uniform(uint64_t bound) {
+  if (bound == 0) throw std::invalid_argument("El rango del número aleatorio no puede estar vacío");
+  const uint64_t threshold = (0 - bound) % bound;
+  uint64_t value;
+  do {
+    fill(reinterpret_cast<uint8_t*>(&value), sizeof(value));
+  } while (value < threshold);
+  return value % bound;
+}
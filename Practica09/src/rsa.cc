@@ -1,4 +1,5 @@
 #include "../include/rsa.h"
+#include "../include/csprng.h"
 
 /**
  * @brief Constructor de la clase RSA.
@@ -79,6 +80,9 @@ bool RSA::LehmanPeralta(int prime) {
   // Lista de primos pequeños para la comprobación inicial rápida
   std::vector<int> short_primes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
 
+  // Ni 1 ni los negativos son primos (y dejarían vacío el rango de números aleatorios)
+  if (prime < 2) return false;
+
   // Comprobación inicial rápida para los primeros primos
   for (int short_prime : short_primes) {
     if (prime == short_prime)
@@ -87,10 +91,6 @@ bool RSA::LehmanPeralta(int prime) {
       return false;  // Si prime es divisible por alguno, no es primo
   }
 
-  // Inicialización de la semilla de tiempo para la generación de números
-  // aleatorios
-  std::srand(std::time(NULL));
-
   // Contadores para resultados específicos de la exponenciación rápida
   unsigned int counter1 = 0, counterM1 = 0;
 
@@ -98,7 +98,8 @@ bool RSA::LehmanPeralta(int prime) {
   for (int i = 0; i < kIteraciones; i++) {
     // Genera un número aleatorio entre 2 y prime - 2 para cada iteración para no usar 1 ni prime - 1
     // pues no aportan información
-    int kRandNumber = std::rand() % (prime - 2) + 2;
+    // (Csprng del hilo: sin sesgo de módulo y sin resembrar en cada llamada)
+    int kRandNumber = 2 + static_cast<int>(Csprng::threadLocal().uniform(prime - 3));
 
     // Realizamos la exponenciación rápida con el número aleatorio generado
     int expResult = ExponenciacionRapida(kRandNumber, (prime - 1) / 2, prime);